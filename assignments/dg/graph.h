@@ -1,66 +1,609 @@
 #ifndef ASSIGNMENTS_DG_GRAPH_H_
 #define ASSIGNMENTS_DG_GRAPH_H_
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <set>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace gdwg {
-using std::shared_ptr;
-using std::weak_ptr;
+
+// Trait for checking whether std::hash can be used on a type
+template <typename T, typename = void>
+struct isHashable : std::false_type {};
+
+template <typename T>
+struct isHashable<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T&>()))>>
+  : std::true_type {};
+
+// Trait for checking whether a type is an iterator
+template <typename T, typename = void>
+struct isIterator : std::false_type {};
+
+template <typename T>
+struct isIterator<T, std::void_t<typename std::iterator_traits<T>::iterator_category>>
+  : std::true_type {};
+
+// Trait for checking whether a type is a range that can be iterated with std::begin and std::end
+template <typename T, typename = void>
+struct isRange : std::false_type {};
+
+template <typename T>
+struct isRange<T,
+               std::void_t<decltype(std::begin(std::declval<T&>())),
+                           decltype(std::end(std::declval<T&>()))>> : std::true_type {};
+
+// Trait for graphs stored densely, with the adjacency of each node in flat sorted arrays
+// Defaults to integral nodes with trivially copyable weights, and can be specialised either way
+template <typename N, typename E>
+struct isDense
+  : std::bool_constant<std::is_integral<N>::value && std::is_trivially_copyable<E>::value> {};
+
+// Set kept as a sorted array, for small elements where a tree node costs several times as much
+// Lookups are binary searches, while inserts and erases shift the elements after them
+template <typename T, typename Compare>
+class FlatSet {
+ public:
+  using const_iterator = typename std::pmr::vector<T>::const_iterator;
+
+  explicit FlatSet(std::pmr::memory_resource* resource) : elements_{resource} {}
+
+  const_iterator begin() const noexcept { return elements_.begin(); }
+  const_iterator end() const noexcept { return elements_.end(); }
+  std::size_t size() const noexcept { return elements_.size(); }
+  bool empty() const noexcept { return elements_.empty(); }
+
+  template <typename K>
+  const_iterator lower_bound(const K& key) const {
+    return std::lower_bound(elements_.begin(), elements_.end(), key, compare_);
+  }
+
+  template <typename K>
+  const_iterator find(const K& key) const {
+    auto itr = lower_bound(key);
+    return itr != end() && !compare_(key, *itr) ? itr : end();
+  }
+
+  template <typename K>
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    return std::equal_range(elements_.begin(), elements_.end(), key, compare_);
+  }
+
+  std::pair<const_iterator, bool> insert(T value) {
+    auto itr = lower_bound(value);
+    if (itr != end() && !compare_(value, *itr))
+      return {itr, false};
+    return {elements_.insert(itr, std::move(value)), true};
+  }
+
+  // Inserts without searching when the value belongs right before the hint
+  const_iterator emplace_hint(const_iterator hint, T value) {
+    if ((hint == end() || compare_(value, *hint)) &&
+        (hint == begin() || compare_(*std::prev(hint), value))) {
+      return elements_.insert(hint, std::move(value));
+    }
+    return insert(std::move(value)).first;
+  }
+
+  template <typename K>
+  std::size_t erase(const K& key) {
+    auto itr = find(key);
+    if (itr == end())
+      return 0;
+    elements_.erase(itr);
+    return 1;
+  }
+
+ private:
+  std::pmr::vector<T> elements_;
+  Compare compare_;
+};
+
+// Memory resources bundled for graphs that are built up and torn down in bulk
+// The arena never frees until it is destroyed, the pool recycles blocks by size class
+using MonotonicArena = std::pmr::monotonic_buffer_resource;
+using PoolResource = std::pmr::unsynchronized_pool_resource;
+
+// Binary serialization of node and weight values for saved graphs
+// Trivially copyable types are written as raw bytes, other types need a specialisation
+template <typename T>
+struct Serializer {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Specialise gdwg::Serializer to save graphs with this type");
+  static constexpr bool raw = true;
+};
+
+// Strings are written as their length followed by their characters
+template <typename CharT, typename Traits, typename Alloc>
+struct Serializer<std::basic_string<CharT, Traits, Alloc>> {
+  static constexpr bool raw = false;
+
+  static void write(std::ostream& os, const std::basic_string<CharT, Traits, Alloc>& value) {
+    std::uint64_t size = value.size();
+    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    os.write(reinterpret_cast<const char*>(value.data()), size * sizeof(CharT));
+  }
+
+  static std::basic_string<CharT, Traits, Alloc> read(std::istream& is) {
+    std::uint64_t size = 0;
+    is.read(reinterpret_cast<char*>(&size), sizeof(size));
+    std::basic_string<CharT, Traits, Alloc> value(is ? size : 0, CharT{});
+    is.read(reinterpret_cast<char*>(&value[0]), value.size() * sizeof(CharT));
+    return value;
+  }
+};
+
+// Priority queue with D children per entry, where top is the least entry under Compare
+// It is shallower than a binary heap and the children of an entry share a cache line
+template <typename T, typename Compare = std::less<T>, std::size_t D = 4>
+class DaryHeap {
+ public:
+  bool empty() const noexcept { return heap_.empty(); }
+
+  void push(T value) {
+    heap_.push_back(std::move(value));
+    for (auto child = heap_.size() - 1; child > 0;) {
+      auto parent = (child - 1) / D;
+      if (!compare_(heap_[child], heap_[parent]))
+        break;
+      std::swap(heap_[child], heap_[parent]);
+      child = parent;
+    }
+  }
+
+  T pop() {
+    T top = std::move(heap_.front());
+    heap_.front() = std::move(heap_.back());
+    heap_.pop_back();
+    for (std::size_t parent = 0;;) {
+      auto first = parent * D + 1;
+      if (first >= heap_.size())
+        break;
+      auto last = std::min(first + D, heap_.size());
+      auto least = std::min_element(heap_.begin() + first, heap_.begin() + last, compare_);
+      if (!compare_(*least, heap_[parent]))
+        break;
+      std::swap(*least, heap_[parent]);
+      parent = least - heap_.begin();
+    }
+    return top;
+  }
+
+ private:
+  std::vector<T> heap_;
+  Compare compare_;
+};
+
+// Runs f(begin, end, thread) over [0, count) split into one contiguous block per thread
+// Small ranges run on the calling thread, since starting threads would cost more than they save
+template <typename F>
+void parallelFor(std::size_t count, std::size_t threads, F&& f) {
+  constexpr std::size_t minimumBlock = 4096;
+  threads = std::max<std::size_t>(1, std::min(threads, count / minimumBlock));
+  auto block = (count + threads - 1) / std::max<std::size_t>(1, threads);
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (std::size_t thread = 1; thread < threads; thread++) {
+    workers.emplace_back([&f, thread, block, count] {
+      f(std::min(thread * block, count), std::min((thread + 1) * block, count), thread);
+    });
+  }
+  f(0, std::min(block, count), 0);
+  for (auto& worker : workers)
+    worker.join();
+}
+
+// Compact handle to a node of a graph, which skips looking the node up by value
+// A handle stays valid until its node is deleted, merged away or cleared, or the graph is
+// assigned to, and is then rejected by every method that takes one
+class NodeId {
+ public:
+  // Constructs a handle that is never valid
+  NodeId() = default;
+
+  friend bool operator==(const NodeId& lhs, const NodeId& rhs) noexcept {
+    return lhs.slot_ == rhs.slot_ && lhs.generation_ == rhs.generation_;
+  }
+  friend bool operator!=(const NodeId& lhs, const NodeId& rhs) noexcept { return !(lhs == rhs); }
+
+ private:
+  NodeId(std::uint32_t slot, std::uint32_t generation) : slot_{slot}, generation_{generation} {}
+  std::uint32_t slot_ = 0;
+  std::uint32_t generation_ = 0;
+
+  template <typename N, typename E>
+  friend class Graph;
+};
+
+// Result of each item of a batch insert, erase or delete
+enum class BatchResult { Inserted, Erased, Deleted, Duplicate, Missing, MissingNode };
+
+// Graphs only count their operations when GDWG_ENABLE_STATS is defined, and the counting compiles
+// away otherwise
+// It must be defined the same way in every translation unit that uses a graph
+#ifdef GDWG_ENABLE_STATS
+constexpr bool statsEnabled = true;
+#else
+constexpr bool statsEnabled = false;
+#endif
+
+// Public methods of Graph that have their calls counted when stats are enabled
+// Overloads share a method, and calls made from within other methods count as well
+enum class GraphMethod {
+  InsertNode,
+  EmplaceNode,
+  InsertNodeId,
+  GetNodeId,
+  GetNode,
+  IsNode,
+  DeleteNode,
+  Replace,
+  MergeReplace,
+  Clear,
+  InsertEdge,
+  erase,
+  find,
+  IsConnected,
+  GetNodes,
+  GetConnected,
+  GetWeights,
+  ShortestPaths,
+  ShortestPath,
+  InsertEdges,
+  EraseEdges,
+  DeleteNodes,
+  Copy,
+  Equal,
+  Print,
+  Freeze,
+  ReadEdgeList,
+};
+constexpr std::size_t graphMethodCount = static_cast<std::size_t>(GraphMethod::ReadEdgeList) + 1;
+
+// Snapshot of the operation counters of every graph of a type, see Graph::Stats
+struct GraphStats {
+  static constexpr std::size_t latencyBuckets = 48;
+
+  // Calls of a method, the edges they walked over and a histogram of how long they took
+  // Bucket i counts the calls that took at least 2^(i - 1) and under 2^i nanoseconds
+  struct Method {
+    std::uint64_t calls_ = 0;
+    std::uint64_t edgesScanned_ = 0;
+    std::array<std::uint64_t, latencyBuckets> latency_{};
+  };
+
+  // Node comparisons are those made by the node index and the edge order
+  // Allocations are those made from the graphs' memory resources
+  std::uint64_t nodeComparisons_ = 0;
+  std::uint64_t edgeComparisons_ = 0;
+  std::uint64_t allocations_ = 0;
+  std::uint64_t bytesAllocated_ = 0;
+  std::array<Method, graphMethodCount> methods_{};
+
+  const Method& operator[](GraphMethod method) const {
+    return methods_[static_cast<std::size_t>(method)];
+  }
+};
+
+template <typename N, typename E>
+class FrozenGraph;
+
+template <typename N, typename E>
+class GraphBuilder;
 
 template <typename N, typename E>
 class Graph {
  private:
+  struct Node;
+
   // Private struct for internal representation of an Edge
   struct Edge {
-    // Edges have weak pointers to look at nodes and a weight of type E
-    Edge(shared_ptr<N> source, shared_ptr<N> destination, const E& weight)
-      : source_{source}, destination_{destination}, weight_{weight} {}
-    weak_ptr<N> source_;
-    weak_ptr<N> destination_;
+    // Edges point straight at their nodes and have a weight of type E
+    // Nodes outlive their edges since DeleteNode unlinks every edge of a node first
+    template <typename W>
+    Edge(Node* source, Node* destination, W&& weight)
+      : source_{source}, destination_{destination}, weight_{std::forward<W>(weight)} {}
+    Node* source_;
+    Node* destination_;
     E weight_;
   };
 
+  // Key for looking up an edge by value without allocating an Edge
+  // A key without a weight matches every edge between source and destination
+  struct EdgeKey {
+    const N& source_;
+    const N& destination_;
+    const E* weight_;
+  };
+
+  // Comparators for node values, which count their comparisons when stats are enabled
+  struct equalNodes {
+    bool operator()(const N& lhs, const N& rhs) const {
+      countNodeComparison();
+      return lhs == rhs;
+    }
+  };
+  struct lessNodes {
+    bool operator()(const N& lhs, const N& rhs) const {
+      countNodeComparison();
+      return lhs < rhs;
+    }
+  };
+
   // Sort Comparator for the set of edges
+  // Transparent so that edges, pointers to edges and keys can all be compared
   struct sortEdges {
-    bool operator()(const shared_ptr<Edge>& edge1, const shared_ptr<Edge>& edge2) const {
-      shared_ptr<N> source1 = edge1->source_.lock();
-      shared_ptr<N> source2 = edge2->source_.lock();
-      shared_ptr<N> destination1 = edge1->destination_.lock();
-      shared_ptr<N> destination2 = edge2->destination_.lock();
-
-      if (*source1 == *source2) {
-        if (*destination1 == *destination2)
-          return edge1->weight_ < edge2->weight_;
-        return *destination1 < *destination2;
+    using is_transparent = void;
+
+    template <typename T1, typename T2>
+    bool operator()(const T1& lhs, const T2& rhs) const {
+      return less(key(lhs), key(rhs));
+    }
+
+    static EdgeKey key(const Edge& edge) {
+      return {edge.source_->value_, edge.destination_->value_, &edge.weight_};
+    }
+    static EdgeKey key(const Edge* edge) { return key(*edge); }
+    static const EdgeKey& key(const EdgeKey& key) { return key; }
+
+    // Orders by source, then destination and then weight
+    // Values at the same address are the same node, so they are equal without comparing them
+    static bool less(const EdgeKey& key1, const EdgeKey& key2) {
+      countEdgeComparison();
+      if (&key1.source_ == &key2.source_ || equalNodes{}(key1.source_, key2.source_)) {
+        if (&key1.destination_ == &key2.destination_ ||
+            equalNodes{}(key1.destination_, key2.destination_))
+          return key1.weight_ && key2.weight_ && *key1.weight_ < *key2.weight_;
+        return lessNodes{}(key1.destination_, key2.destination_);
       }
-      return *source1 < *source2;
+      return lessNodes{}(key1.source_, key2.source_);
     }
   };
 
-  // Function to get Outgoing Edges from a Node
-  std::set<shared_ptr<Edge>, sortEdges> getOutEdges(const N& node) const {
-    std::set<shared_ptr<Edge>, sortEdges> nodeEdges;
-    for (auto edge : edges_) {
-      shared_ptr<N> source = edge->source_.lock();
-      if (*source == node) {
-        nodeEdges.insert(edge);
-      }
+  // The edge set owns the edges, nodes only refer to the edges they are part of
+  // Dense graphs keep those references in flat arrays, which cost a pointer per edge rather than
+  // a tree node, at the price of inserts and erases linear in the degree
+  // Every container and node of a graph allocates from the graph's memory resource
+  using EdgeSet = std::pmr::set<Edge, sortEdges>;
+  using EdgeRefs = std::conditional_t<isDense<N, E>::value,
+                                      FlatSet<const Edge*, sortEdges>,
+                                      std::pmr::set<const Edge*, sortEdges>>;
+
+  // Private struct for internal representation of a Node
+  struct Node {
+    // Nodes own their value and keep their own outgoing and incoming edges
+    // Both lists use the global edge order, so they are sorted by destination and source
+    template <typename... Args>
+    explicit Node(std::pmr::memory_resource* resource, Args&&... args)
+      : value_(std::forward<Args>(args)...), out_{resource}, in_{resource} {}
+    N value_;
+    EdgeRefs out_;
+    EdgeRefs in_;
+    std::uint32_t slot_ = 0;
+  };
+
+  // Slot of the node a NodeId refers to, with a generation that is bumped when the node goes
+  // Slots of nodes that have gone are reused, and the free list is reserved for every slot
+  struct Slot {
+    Node* node_;
+    std::uint32_t generation_;
+  };
+
+  // Deleter that hands a node back to the resource it was allocated from
+  struct NodeDeleter {
+    void operator()(Node* node) const {
+      node->~Node();
+      resource_->deallocate(node, sizeof(Node), alignof(Node));
+    }
+    std::pmr::memory_resource* resource_;
+  };
+  using NodePtr = std::unique_ptr<Node, NodeDeleter>;
+
+  // Nodes are indexed by a reference to the value they own
+  // Hashed when N is hashable, ordered otherwise
+  using NodeKey = std::reference_wrapper<const N>;
+  using NodeIndex = std::conditional_t<
+      isHashable<N>::value,
+      std::pmr::unordered_map<NodeKey, NodePtr, std::hash<N>, equalNodes>,
+      std::pmr::map<NodeKey, NodePtr, lessNodes>>;
+
+  // Function to allocate a node from the graph's memory resource, constructing its value in place
+  template <typename... Args>
+  NodePtr makeNode(Args&&...);
+
+  // Functions that copy or move their arguments into the graph for the public overloads
+  template <typename T>
+  bool insertNode(T&&);
+  template <typename W>
+  bool insertEdge(const N&, const N&, W&&);
+  template <typename T>
+  bool replace(const N&, T&&);
+
+  // Function to insert an edge between two nodes of the graph if it does not already exist
+  template <typename W>
+  bool insertEdgeBetween(Node*, Node*, W&&);
+
+  // Functions to add a new node to the index and to remove one, keeping its slot up to date
+  Node* indexNode(NodePtr);
+  void eraseNode(typename NodeIndex::iterator) noexcept;
+  void releaseSlot(const Node&) noexcept;
+
+  // Functions to look up a node by handle, returning null if the handle is not valid
+  Node* nodeOf(NodeId) const noexcept;
+  NodeId idOf(const Node&) const noexcept;
+
+  // Function to clone the nodes and edges of another graph into this empty one
+  void cloneFrom(const Graph&);
+
+  // Function to find a node, inserting it first if it is not in the graph yet
+  template <typename T>
+  Node* findOrInsertNode(T&&);
+
+  // Functions to bulk load a batch of edges, inserting their nodes as needed
+  // The sorted version needs the batch in edge order, but it may have duplicates
+  void bulkLoad(std::vector<std::tuple<N, N, E>>);
+  void bulkLoadSorted(std::vector<std::tuple<N, N, E>>);
+  static bool lessEdgeTuple(const std::tuple<N, N, E>&, const std::tuple<N, N, E>&);
+
+  // A chunk of an edge list, holding whole lines and the fields of each line
+  // Fields view into the chunk's text, so the text must outlive them
+  struct EdgeListChunk {
+    std::string text_;
+    std::vector<std::array<std::string_view, 3>> records_;
+    bool last_ = false;
+  };
+  using EdgeListReader = std::function<std::size_t(char*, std::size_t)>;
+  static constexpr std::size_t edgeListChunkSize_ = 1 << 20;
+
+  // Functions for streaming in an edge list one chunk at a time
+  static Graph readEdgeList(const EdgeListReader&, std::pmr::memory_resource*);
+  static void readEdgeListChunk(const EdgeListReader&, EdgeListChunk&, std::string& carry);
+  void insertEdgeListChunk(const EdgeListChunk&, std::vector<std::tuple<Node*, Node*, E>>&);
+
+  // Function to parse a single field of an edge list into an existing value
+  template <typename T>
+  static void parseField(std::string_view, T&);
+
+  // Distance of a node from the source of a shortest path search and the node it was reached from
+  struct Label {
+    E distance_;
+    const Node* parent_;
+    bool settled_;
+  };
+
+  // Comparator for shortest path search entries, so that the closest node is searched first
+  struct closerFirst {
+    bool operator()(const std::pair<E, const Node*>& a, const std::pair<E, const Node*>& b) const {
+      return a.first < b.first;
     }
+  };
 
-    return nodeEdges;
-  }
+  // Function to search for the shortest paths from a node, stopping once target is settled
+  std::unordered_map<const Node*, Label> dijkstra(const Node&, const Node* target) const;
+
+  // Function to get the order of a batch of edges once sorted, with equal edges in batch order
+  static std::vector<std::size_t> sortedOrder(const std::vector<std::tuple<N, N, E>>&);
+
+  // Functions to iterate a range, moving the elements out if the range is an rvalue
+  template <typename Range>
+  static auto rangeBegin(Range&&);
+  template <typename Range>
+  static auto rangeEnd(Range&&);
+
+  // Functions to add and remove an edge from the edge set and its nodes' adjacency
+  // Unlinked edges are handed back so that they can be relinked without reallocating
+  void linkEdge(typename EdgeSet::node_type);
+  void linkAdjacency(const Edge&);
+  typename EdgeSet::node_type unlinkEdge(const Edge&);
+
+  // Function to unlink every edge touching a node and return them
+  std::vector<typename EdgeSet::node_type> unlinkIncidentEdges(Node&);
+
+  // Counters behind Stats, shared by every graph of this type
+  struct StatsCounters {
+    struct Method {
+      std::atomic<std::uint64_t> calls_;
+      std::atomic<std::uint64_t> edgesScanned_;
+      std::array<std::atomic<std::uint64_t>, GraphStats::latencyBuckets> latency_;
+    };
+    std::atomic<std::uint64_t> nodeComparisons_;
+    std::atomic<std::uint64_t> edgeComparisons_;
+    std::atomic<std::uint64_t> allocations_;
+    std::atomic<std::uint64_t> bytesAllocated_;
+    std::array<Method, graphMethodCount> methods_;
+  };
+  static inline StatsCounters stats_;
+
+  // Functions to count operations, which do nothing unless stats are enabled
+  static void countNodeComparison() noexcept;
+  static void countEdgeComparison() noexcept;
+  static void countEdgesScanned(GraphMethod, std::size_t) noexcept;
+  static void countCall(GraphMethod, std::chrono::steady_clock::duration) noexcept;
+
+  // Records a call of a public method and how long it took once it goes out of scope
+  class StatsScope {
+   public:
+    explicit StatsScope(GraphMethod method) noexcept : method_{method} {
+      if constexpr (statsEnabled)
+        start_ = std::chrono::steady_clock::now();
+    }
+    ~StatsScope() {
+      if constexpr (statsEnabled)
+        countCall(method_, std::chrono::steady_clock::now() - start_);
+    }
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
+
+   private:
+    GraphMethod method_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  // Memory resource that counts the allocations of graphs before passing them upstream
+  class StatsResource : public std::pmr::memory_resource {
+   public:
+    explicit StatsResource(std::pmr::memory_resource* upstream) : upstream_{upstream} {}
+
+   private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+      stats_.allocations_.fetch_add(1, std::memory_order_relaxed);
+      stats_.bytesAllocated_.fetch_add(bytes, std::memory_order_relaxed);
+      return upstream_->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+      upstream_->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+    std::pmr::memory_resource* upstream_;
+  };
+
+  // Function to get the resource a graph allocates from, wrapping it if stats are enabled
+  static std::pmr::memory_resource* statsResource(std::pmr::memory_resource*);
+
+  friend class GraphBuilder<N, E>;
 
   // Internal representation of the nodes and edges of a graph
-  std::vector<shared_ptr<N>> nodes_;
-  std::set<shared_ptr<Edge>, sortEdges> edges_;
+  std::pmr::memory_resource* resource_;
+  NodeIndex nodes_;
+  EdgeSet edges_;
+  std::pmr::vector<Slot> slots_;
+  std::pmr::vector<std::uint32_t> freeSlots_;
 
  public:
   // ----------------------- Iterators ---------------------------
@@ -76,10 +619,8 @@ class Graph {
 
     // Pointer deferencing for iterator
     reference operator*() const {
-      shared_ptr<Edge> edge = *edge_itr_;
-      shared_ptr<N> source = edge->source_.lock();
-      shared_ptr<N> destination = edge->destination_.lock();
-      return {*source, *destination, edge->weight_};
+      const Edge& edge = *edge_itr_;
+      return {edge.source_->value_, edge.destination_->value_, edge.weight_};
     }
 
     // Pre-incremement operator for iterator
@@ -123,9 +664,9 @@ class Graph {
     }
 
    private:
-    typename std::set<shared_ptr<Edge>>::const_iterator edge_itr_;
-    typename std::set<shared_ptr<Edge>>::const_iterator begin_sentinel_;
-    typename std::set<shared_ptr<Edge>>::const_iterator end_sentinel_;
+    typename EdgeSet::const_iterator edge_itr_;
+    typename EdgeSet::const_iterator begin_sentinel_;
+    typename EdgeSet::const_iterator end_sentinel_;
     const_iterator(const decltype(edge_itr_)& edge_itr,
                    const decltype(begin_sentinel_)& begin_sentinel,
                    const decltype(end_sentinel_)& end_sentinel)
@@ -144,10 +685,8 @@ class Graph {
     using difference_type = int;
 
     reference operator*() const {
-      shared_ptr<Edge> edge = *edge_itr_;
-      shared_ptr<N> source = edge->source_.lock();
-      shared_ptr<N> destination = edge->destination_.lock();
-      return {*source, *destination, edge->weight_};
+      const Edge& edge = *edge_itr_;
+      return {edge.source_->value_, edge.destination_->value_, edge.weight_};
     }
     const_reverse_iterator operator++() {
       if (edge_itr_ != end_sentinel_) {
@@ -181,9 +720,9 @@ class Graph {
     }
 
    private:
-    typename std::set<shared_ptr<Edge>>::const_reverse_iterator edge_itr_;
-    typename std::set<shared_ptr<Edge>>::const_reverse_iterator begin_sentinel_;
-    typename std::set<shared_ptr<Edge>>::const_reverse_iterator end_sentinel_;
+    typename EdgeSet::const_reverse_iterator edge_itr_;
+    typename EdgeSet::const_reverse_iterator begin_sentinel_;
+    typename EdgeSet::const_reverse_iterator end_sentinel_;
     const_reverse_iterator(const decltype(edge_itr_)& edge_itr,
                            const decltype(begin_sentinel_)& begin_sentinel,
                            const decltype(end_sentinel_)& end_sentinel)
@@ -213,17 +752,26 @@ class Graph {
   // ----------------------- Constructors ----------------------------
 
   // Default Constructor
-  Graph() = default;
+  Graph() : Graph(std::pmr::get_default_resource()) {}
+
+  // Construct an empty graph that allocates its nodes and edges from the given resource
+  explicit Graph(std::pmr::memory_resource*);
 
-  // Construct from list of nodes
-  Graph(typename std::vector<N>::const_iterator, typename std::vector<N>::const_iterator);
+  // Construct from a list of nodes or a list of (src, dst, weight) edge tuples
+  // Edge lists are sorted and deduplicated once and then loaded in bulk
+  // Pass move iterators to move the elements into the graph
+  template <typename InputIt, typename = std::enable_if_t<isIterator<InputIt>::value>>
+  Graph(InputIt, InputIt, std::pmr::memory_resource* = std::pmr::get_default_resource());
 
-  // Construct from list of edges
-  Graph(typename std::vector<std::tuple<N, N, E>>::const_iterator,
-        typename std::vector<std::tuple<N, N, E>>::const_iterator);
+  // Construct from a range of nodes or edge tuples, moving the elements out of an rvalue range
+  template <typename Range,
+            typename = std::enable_if_t<isRange<Range>::value &&
+                                        !std::is_same<std::decay_t<Range>, Graph>::value>>
+  explicit Graph(Range&&, std::pmr::memory_resource* = std::pmr::get_default_resource());
 
   // Construct from initialiser list of nodes
-  Graph(typename std::initializer_list<N>);
+  Graph(typename std::initializer_list<N>,
+        std::pmr::memory_resource* = std::pmr::get_default_resource());
 
   // Copy constructor
   Graph(const Graph&);
@@ -239,24 +787,33 @@ class Graph {
   // Copy Assignment
   Graph& operator=(const Graph&) noexcept;
 
-  // Default Move Assignment
-  Graph& operator=(Graph&&) = default;
+  // Move Assignment
+  Graph& operator=(Graph&&) noexcept;
 
   // Helper Functions
-  shared_ptr<N> getNode(const N&) const noexcept;
+  const N* getNode(const N&) const noexcept;
   bool isEdge(const N&, const N&, const E&) const noexcept;
 
   // ----------------------- Methods ----------------------------
 
   // Method for inserting a new node into the graph if it doesnt already exist
+  // The rvalue overload moves the value into the graph
   bool InsertNode(const N&) noexcept;
+  bool InsertNode(N&&) noexcept;
+
+  // Method for constructing a new node in place from the given arguments
+  // The node is discarded if an equal node already exists
+  template <typename... Args>
+  bool EmplaceNode(Args&&...);
 
   // Method for deleting a node if it exists
   bool DeleteNode(const N&) noexcept;
 
   // Method for replacing a node with another if the old node exists and the new does not
   // Exception is thrown otherwise
+  // The rvalue overload moves the new value into the graph
   bool Replace(const N&, const N&);
+  bool Replace(const N&, N&&);
 
   // Method for replacing the edges of a node with another node - both in the graph
   // Old node is deleted
@@ -271,6 +828,26 @@ class Graph {
   // Method for checking if a node exists in the graph
   bool IsNode(const N&) const noexcept;
 
+  // Methods for getting the handle of a node, inserting the node first if it does not exist
+  NodeId InsertNodeId(const N&);
+  NodeId InsertNodeId(N&&);
+
+  // Method for getting the handle of a node
+  // Throws exception if the node is not present in the graph
+  NodeId GetNodeId(const N&) const;
+
+  // Methods for working with nodes by handle rather than by value
+  // Throws exception if a handle is not valid, except for IsNode and erase
+  // GetConnected returns handles rather than values
+  bool IsNode(NodeId) const noexcept;
+  const N& GetNode(NodeId) const;
+  bool InsertEdge(NodeId, NodeId, const E&);
+  bool InsertEdge(NodeId, NodeId, E&&);
+  bool IsConnected(NodeId, NodeId) const;
+  std::vector<NodeId> GetConnected(NodeId) const;
+  std::vector<E> GetWeights(NodeId, NodeId) const;
+  bool erase(NodeId, NodeId, const E&) noexcept;
+
   // Method for checking if there is at least one edge from src to dest
   bool IsConnected(const N&, const N&) const;
 
@@ -285,11 +862,35 @@ class Graph {
   // Throws exception if either node is not present in the graph
   std::vector<E> GetWeights(const N&, const N&) const;
 
+  // Method for getting the shortest distance from src to every node it can reach, sorted by node
+  // Parallel edges count with their least weight, and a default constructed E is a distance of 0
+  // Throws exception if src is not in the graph or a reachable edge has a negative weight
+  std::vector<std::pair<N, E>> ShortestPaths(const N&) const;
+
+  // Method for getting the distance and the nodes along the shortest path from src to dst
+  // Returns nothing if dst can't be reached from src
+  // Throws exception if either node is not in the graph or a reachable edge has a negative weight
+  std::optional<std::pair<E, std::vector<N>>> ShortestPath(const N&, const N&) const;
+
   // Method for deleting a given edge if it exists
   bool erase(const N&, const N&, const E&) noexcept;
 
   // Method for inserting an edge if it does not already exist
+  // The rvalue overload moves the weight into the graph
   bool InsertEdge(const N&, const N&, const E&);
+  bool InsertEdge(const N&, const N&, E&&);
+
+  // Methods for applying a batch of changes from a range, with a result for each item in order
+  // Edges are given as tuples of src, dst and weight, and the batch is sorted once so that each
+  // edge needs one search of the edge set and each run of edges from a node one node lookup
+  // Inserts give Inserted, Duplicate or MissingNode; erases Erased or Missing
+  // Deletes give Deleted or Missing
+  template <typename Range>
+  std::vector<BatchResult> InsertEdges(Range&&);
+  template <typename Range>
+  std::vector<BatchResult> EraseEdges(Range&&);
+  template <typename Range>
+  std::vector<BatchResult> DeleteNodes(Range&&);
 
   // Method for returning an iterator to a given edge
   // Return end iterator if not found
@@ -300,44 +901,68 @@ class Graph {
   // return end iterator otherwise
   const_iterator erase(const_iterator it) noexcept;
 
+  // Method for compacting the graph into an immutable snapshot for read heavy workloads
+  FrozenGraph<N, E> Freeze() const;
+
+  // Method for writing the graph to a file in the binary format of FrozenGraph::Save
+  void Save(const std::string&) const;
+
+  // Methods for getting the PageRank of every node in sorted order, see FrozenGraph::PageRank
+  std::vector<std::pair<N, double>> PageRank(
+      double damping = 0.85,
+      double tolerance = 1e-9,
+      std::size_t maxIterations = 100,
+      std::size_t threads = std::thread::hardware_concurrency()) const;
+  std::vector<std::pair<N, double>> WeightedPageRank(
+      double damping = 0.85,
+      double tolerance = 1e-9,
+      std::size_t maxIterations = 100,
+      std::size_t threads = std::thread::hardware_concurrency()) const;
+
+  // Methods for getting the component of every node in sorted order, see FrozenGraph
+  std::vector<std::pair<N, std::size_t>> StronglyConnectedComponents() const;
+  std::vector<std::pair<N, std::size_t>> WeaklyConnectedComponents(
+      std::size_t threads = std::thread::hardware_concurrency()) const;
+
+  // Method for reading a graph written by Save
+  // Throws exception if the file can't be read or was not written by Save
+  static Graph Load(const std::string&);
+
+  // Methods for streaming in a graph from lines of whitespace separated "src dst weight"
+  // The input is read in chunks, and each chunk is tokenised while the last one is inserted
+  // Throws exception if the input can't be read or a line can't be parsed
+  static Graph ReadEdgeList(std::istream&,
+                            std::pmr::memory_resource* = std::pmr::get_default_resource());
+  static Graph ReadEdgeList(int fd, std::pmr::memory_resource* = std::pmr::get_default_resource());
+
+  // Methods for reading and resetting the operation counters of every graph of this type
+  // Counters are only collected when GDWG_ENABLE_STATS is defined, and are all zero otherwise
+  static GraphStats Stats() noexcept;
+  static void ResetStats() noexcept;
+
   // ----------------------- Friends ----------------------------
 
   // Equality Operator Overload
   friend bool operator==(const Graph& g1, const Graph& g2) {
-    // Compare if nodes are the same
-    if (g1.nodes_.size() != g2.nodes_.size())
+    StatsScope scope{GraphMethod::Equal};
+    // Compare the sizes first since they are the cheapest to check
+    if (g1.nodes_.size() != g2.nodes_.size() || g1.edges_.size() != g2.edges_.size())
       return false;
-
-    for (auto nodeG1 : g1.nodes_) {
-      auto present = false;
-      for (auto nodeG2 : g2.nodes_) {
-        if (*nodeG1 == *nodeG2) {
-          present = true;
-          break;
-        }
-      }
-      if (present == false)
-        return false;
-    }
+    countEdgesScanned(GraphMethod::Equal, g1.edges_.size());
 
     // Compare if edges are the same
-    if (g1.edges_.size() != g2.edges_.size())
+    // Both edge sets are in the same order, so equal graphs have equal edges at every position
+    auto sameEdge = [](const Edge& edgeG1, const Edge& edgeG2) -> bool {
+      return edgeG1.source_->value_ == edgeG2.source_->value_ &&
+             edgeG1.destination_->value_ == edgeG2.destination_->value_ &&
+             edgeG1.weight_ == edgeG2.weight_;
+    };
+    if (!std::equal(g1.edges_.begin(), g1.edges_.end(), g2.edges_.begin(), sameEdge))
       return false;
 
-    for (auto edgeG1 : g1.edges_) {
-      auto present = false;
-      for (auto edgeG2 : g2.edges_) {
-        shared_ptr<N> source1 = edgeG1->source_.lock();
-        shared_ptr<N> destination1 = edgeG1->destination_.lock();
-        shared_ptr<N> source2 = edgeG2->source_.lock();
-        shared_ptr<N> destination2 = edgeG2->destination_.lock();
-        if (*source1 == *source2 && *destination1 == *destination2 &&
-            edgeG1->weight_ == edgeG2->weight_) {
-          present = true;
-          break;
-        }
-      }
-      if (present == false)
+    // Compare if nodes are the same
+    for (const auto& node : g1.nodes_) {
+      if (!g2.IsNode(node.second->value_))
         return false;
     }
 
@@ -349,19 +974,24 @@ class Graph {
 
   // OutStream Operator Overload
   friend std::ostream& operator<<(std::ostream& os, const Graph& g) {
-    std::vector<shared_ptr<N>> nodes = g.nodes_;
+    StatsScope scope{GraphMethod::Print};
+    countEdgesScanned(GraphMethod::Print, g.edges_.size());
+    std::vector<const Node*> nodes;
+    nodes.reserve(g.nodes_.size());
+    for (const auto& node : g.nodes_)
+      nodes.push_back(node.second.get());
 
     std::sort(nodes.begin(), nodes.end(),
-              [](const shared_ptr<N>& a, const shared_ptr<N>& b) -> bool { return *a < *b; });
+              [](const Node* a, const Node* b) -> bool { return a->value_ < b->value_; });
 
+    // Edges are sorted by source, so one pass over them lines up with the sorted nodes
+    // Lines end in '\n' rather than std::endl so the stream buffers instead of flushing each edge
+    auto edge = g.edges_.begin();
     for (auto node : nodes) {
-      os << *node << " (\n";
-
-      std::set<shared_ptr<Edge>, sortEdges> edges = g.getOutEdges(*node);
+      os << node->value_ << " (\n";
 
-      for (auto edge : edges) {
-        shared_ptr<N> destination1 = edge->destination_.lock();
-        os << "  " << *destination1 << " | " << edge->weight_ << std::endl;
+      for (; edge != g.edges_.end() && edge->source_ == node; ++edge) {
+        os << "  " << edge->destination_->value_ << " | " << edge->weight_ << '\n';
       }
 
       os << ")\n";
@@ -370,6 +1000,415 @@ class Graph {
     return os;
   }
 };
+
+// Immutable compressed sparse row snapshot of a Graph
+// Nodes are stored in sorted order and the edges of node i are at [offsets_[i], offsets_[i + 1])
+template <typename N, typename E>
+class FrozenGraph {
+ public:
+  // ----------------------- Iterators ---------------------------
+
+  // Const Iterator
+  class const_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::tuple<N, N, E>;
+    using reference = std::tuple<const N&, const N&, const E&>;
+    using pointer = std::tuple<N, N, E>*;
+    using difference_type = int;
+
+    // Pointer deferencing for iterator
+    reference operator*() const {
+      return {graph_->nodes_[row_], graph_->nodes_[graph_->destinations_[edge_]],
+              graph_->weights_[edge_]};
+    }
+
+    // Pre-incremement operator for iterator
+    const_iterator operator++() {
+      if (edge_ != graph_->edgeCount_) {
+        ++edge_;
+        while (row_ < graph_->nodeCount_ && graph_->offsets_[row_ + 1] <= edge_)
+          ++row_;
+      }
+      return *this;
+    }
+
+    // Post increment for iterator
+    const_iterator operator++(int) {
+      auto copy{*this};
+      ++(*this);
+      return copy;
+    }
+
+    // Pre decrement for iterator
+    const_iterator operator--() {
+      if (edge_ != 0) {
+        --edge_;
+        while (graph_->offsets_[row_] > edge_)
+          --row_;
+      }
+      return *this;
+    }
+
+    // Post Decrement for iterator
+    const_iterator operator--(int) {
+      auto copy{*this};
+      --(*this);
+      return copy;
+    }
+
+    // Equality operator for iterator
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs.edge_ == rhs.edge_;
+    }
+
+    // Inequality operator for iterator
+    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    const FrozenGraph* graph_;
+    std::size_t row_;
+    std::size_t edge_;
+    const_iterator(const FrozenGraph* graph, std::size_t row, std::size_t edge)
+      : graph_{graph}, row_{row}, edge_{edge} {}
+
+    friend class FrozenGraph;
+  };
+
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  // -------------------- Iterator Constructors ----------------------
+
+  const_iterator cbegin() const { return {this, firstRow(), 0}; }
+  const_iterator cend() const { return {this, nodeCount_, edgeCount_}; }
+  const_iterator begin() const { return cbegin(); }
+  const_iterator end() const { return cend(); }
+  const_reverse_iterator crbegin() const { return const_reverse_iterator{cend()}; }
+  const_reverse_iterator crend() const { return const_reverse_iterator{cbegin()}; }
+  const_reverse_iterator rbegin() const { return crbegin(); }
+  const_reverse_iterator rend() const { return crend(); }
+
+  // ----------------------- Constructors ----------------------------
+
+  // Default Constructor
+  FrozenGraph() : FrozenGraph(Arrays{{}, {0}, {}, {}}) {}
+
+  // Loads a snapshot written by Save
+  // Files of trivially copyable nodes and weights are memory mapped and used in place
+  // Throws exception if the file can't be read or was not written by Save
+  static FrozenGraph Load(const std::string&);
+
+  // ----------------------- Methods ----------------------------
+
+  // Method for checking if a node exists in the snapshot
+  bool IsNode(const N&) const noexcept;
+
+  // Method for checking if there is at least one edge from src to dest
+  bool IsConnected(const N&, const N&) const;
+
+  // Method for getting all the nodes of the snapshot in sorted order
+  std::vector<N> GetNodes() const noexcept { return {nodes_, nodes_ + nodeCount_}; }
+
+  // Method for getting the nodes that have an edge from the given node
+  // Throws exception if the node is not present in the snapshot
+  std::vector<N> GetConnected(const N&) const;
+
+  // Method for getting the weights of all the edges from src to dest in ascending order of weight
+  // Throws exception if either node is not present in the snapshot
+  std::vector<E> GetWeights(const N&, const N&) const;
+
+  // Method for getting the number of hops from src to every node it can reach, sorted by node
+  // Traversal is breadth first on up to the given number of threads
+  // Throws exception if src is not present in the snapshot
+  std::vector<std::pair<N, std::size_t>> HopDistances(
+      const N&,
+      std::size_t threads = std::thread::hardware_concurrency()) const;
+
+  // Method for getting the nodes at most k hops from src, including src, in sorted order
+  // Throws exception if src is not present in the snapshot
+  std::vector<N> KHop(const N&,
+                      std::size_t k,
+                      std::size_t threads = std::thread::hardware_concurrency()) const;
+
+  // Method for multiplying the weighted adjacency matrix by a vector of one value per node
+  // Entry i of the result is the sum of weight * x[j] over the edges from node i to node j
+  // Throws exception if x does not have one value per node
+  template <typename T>
+  std::vector<T> SpMV(const std::vector<T>&,
+                      std::size_t threads = std::thread::hardware_concurrency()) const;
+
+  // Methods for getting the PageRank of every node in sorted order
+  // The weighted rank splits a node's rank between its edges in proportion to their weights
+  // Iteration stops once the total change in rank is under tolerance or after maxIterations
+  std::vector<std::pair<N, double>> PageRank(
+      double damping = 0.85,
+      double tolerance = 1e-9,
+      std::size_t maxIterations = 100,
+      std::size_t threads = std::thread::hardware_concurrency()) const;
+  std::vector<std::pair<N, double>> WeightedPageRank(
+      double damping = 0.85,
+      double tolerance = 1e-9,
+      std::size_t maxIterations = 100,
+      std::size_t threads = std::thread::hardware_concurrency()) const;
+
+  // Method for getting the strongly connected component of every node in sorted order
+  // Components are numbered from 0 in the order of their first node
+  std::vector<std::pair<N, std::size_t>> StronglyConnectedComponents() const;
+
+  // Method for getting the weakly connected component of every node in sorted order
+  // Components are numbered from 0 in the order of their first node
+  std::vector<std::pair<N, std::size_t>> WeaklyConnectedComponents(
+      std::size_t threads = std::thread::hardware_concurrency()) const;
+
+  // Method for writing the snapshot to a file in the versioned binary format
+  // Throws exception if the file can't be written
+  void Save(const std::string&) const;
+
+ private:
+  // Arrays for a snapshot that owns its data rather than viewing a mapped file
+  struct Arrays {
+    std::vector<N> nodes_;
+    std::vector<std::size_t> offsets_;
+    std::vector<std::size_t> destinations_;
+    std::vector<E> weights_;
+  };
+
+  // Header at the start of a saved snapshot
+  // Sizes are 0 for values written through a Serializer rather than as raw bytes
+  struct FileHeader {
+    char magic_[4];
+    std::uint32_t version_;
+    std::uint32_t indexSize_;
+    std::uint32_t nodeSize_;
+    std::uint32_t weightSize_;
+    std::uint64_t nodeCount_;
+    std::uint64_t edgeCount_;
+    std::uint64_t offsetsAt_;
+    std::uint64_t destinationsAt_;
+    std::uint64_t nodesAt_;
+    std::uint64_t weightsAt_;
+  };
+
+  FrozenGraph(const N* nodes,
+              std::size_t nodeCount,
+              const std::size_t* offsets,
+              const std::size_t* destinations,
+              const E* weights,
+              std::size_t edgeCount,
+              std::shared_ptr<const void> storage)
+    : nodes_{nodes}, nodeCount_{nodeCount}, offsets_{offsets}, destinations_{destinations},
+      weights_{weights}, edgeCount_{edgeCount}, storage_{std::move(storage)} {}
+
+  explicit FrozenGraph(Arrays);
+
+  // Functions for the two ways of loading a file
+  static FrozenGraph mapFile(const std::string&);
+  static FrozenGraph readFile(const std::string&);
+
+  // Function to check a header against the file it was read from
+  static void checkHeader(const FileHeader&, std::uint64_t fileSize);
+
+  // Functions to write and read one array of a saved snapshot
+  template <typename T>
+  static std::uint64_t writeSection(std::ostream&, const T*, std::size_t);
+  template <typename T>
+  static std::vector<T> readSection(std::istream&, std::uint64_t, std::size_t);
+
+  // Version of the binary format written by Save
+  static constexpr std::uint32_t formatVersion_ = 1;
+
+  // Returns the position of a node in nodes_, or nodeCount_ if it is not there
+  std::size_t indexOf(const N&) const noexcept;
+
+  // Returns the first row that has an edge
+  std::size_t firstRow() const noexcept;
+
+  // Incoming edges of every row in the same layout as the outgoing ones
+  // Built the first time a traversal needs them and shared by copies of the snapshot
+  struct Transpose {
+    std::once_flag built_;
+    std::vector<std::size_t> offsets_;
+    std::vector<std::size_t> sources_;
+    std::vector<std::size_t> edges_;
+  };
+  const Transpose& transpose() const;
+
+  // Bitset of rows that threads can set concurrently
+  class AtomicBitset {
+   public:
+    explicit AtomicBitset(std::size_t size) : words_((size + 63) / 64) {}
+    bool test(std::size_t bit) const noexcept {
+      return words_[bit / 64].load(std::memory_order_relaxed) & mask(bit);
+    }
+    // Returns whether this call was the one to set the bit
+    bool set(std::size_t bit) noexcept {
+      return !(words_[bit / 64].fetch_or(mask(bit), std::memory_order_relaxed) & mask(bit));
+    }
+    void clear() noexcept {
+      for (auto& word : words_)
+        word.store(0, std::memory_order_relaxed);
+    }
+
+   private:
+    static std::uint64_t mask(std::size_t bit) noexcept { return std::uint64_t{1} << (bit % 64); }
+    std::vector<std::atomic<std::uint64_t>> words_;
+  };
+
+  // Function for a breadth first search from a row, returning the hops to every row
+  std::vector<std::size_t> breadthFirst(std::size_t source,
+                                        std::size_t maxHops,
+                                        std::size_t threads) const;
+
+  // Function for power iteration of PageRank, returning the rank of every row
+  std::vector<double> pageRank(bool weighted,
+                               double damping,
+                               double tolerance,
+                               std::size_t maxIterations,
+                               std::size_t threads) const;
+
+  // Functions to label every row with a component
+  // The labels only need to be equal within a component, they are numbered by components()
+  std::vector<std::size_t> stronglyConnected() const;
+  std::vector<std::size_t> weaklyConnected(std::size_t threads) const;
+  std::vector<std::pair<N, std::size_t>> components(const std::vector<std::size_t>&) const;
+
+  // Hops to a row that was not reached
+  static constexpr std::size_t unreached_ = std::numeric_limits<std::size_t>::max();
+
+  // Contiguous node array, row offsets and parallel destination and weight arrays
+  // They view either owned Arrays or a mapped file, which storage_ keeps alive
+  // Copies of a snapshot share the same storage
+  const N* nodes_;
+  std::size_t nodeCount_;
+  const std::size_t* offsets_;
+  const std::size_t* destinations_;
+  const E* weights_;
+  std::size_t edgeCount_;
+  std::shared_ptr<const void> storage_;
+  std::shared_ptr<Transpose> transpose_ = std::make_shared<Transpose>();
+
+  friend class Graph<N, E>;
+};
+
+// Builder that many threads can insert into at once, which is then finalized into a Graph
+// Nodes and edges are split into shards by the hash of their node or source node, and each shard
+// has its own lock, so producers only contend when they insert into the same shard
+// Duplicates are kept until Finalize, which removes them with the same rules as Graph
+template <typename N, typename E>
+class GraphBuilder {
+ public:
+  // ----------------------- Constructors ----------------------------
+
+  // Constructor for a builder with the given number of shards
+  // Node types that can't be hashed are all put in one shard
+  explicit GraphBuilder(std::size_t shards = std::thread::hardware_concurrency());
+
+  // ----------------------- Methods ----------------------------
+
+  // Methods for adding a node or an edge, which are safe to call from many threads at once
+  // The nodes of an edge are added along with it
+  void InsertNode(N);
+  void InsertEdge(N, N, E);
+
+  // Method for building the graph, sorting the shards in parallel and merging them
+  // Must not be called while other threads are inserting, and leaves the builder empty
+  Graph<N, E> Finalize(std::pmr::memory_resource* = std::pmr::get_default_resource());
+
+ private:
+  // Each shard is on its own cache line so that locking one does not slow down its neighbours
+  struct alignas(64) Shard {
+    std::mutex mutex_;
+    std::vector<N> nodes_;
+    std::vector<std::tuple<N, N, E>> edges_;
+  };
+
+  // Function to find the shard of a node
+  Shard& shardOf(const N&);
+
+  std::size_t shardCount_;
+  std::unique_ptr<Shard[]> shards_;
+};
+
+// Graph with value semantics where copies share one graph until a copy is changed
+// Copies that are only read never clone the graph
+// A copy must only be used by one thread at a time, as with a Graph
+template <typename N, typename E>
+class CopyOnWriteGraph {
+ public:
+  // ----------------------- Constructors ----------------------------
+
+  // Constructor that takes ownership of a graph
+  explicit CopyOnWriteGraph(Graph<N, E> = {});
+
+  // ----------------------- Methods ----------------------------
+
+  // Methods for reading the graph
+  const Graph<N, E>& operator*() const noexcept { return *graph_; }
+  const Graph<N, E>* operator->() const noexcept { return graph_.get(); }
+
+  // Method for getting the graph to change, cloning it first if another copy shares it
+  Graph<N, E>& Mutable();
+
+  // Method for checking if the graph is shared with another copy
+  bool IsShared() const noexcept { return graph_.use_count() > 1; }
+
+ private:
+  std::shared_ptr<Graph<N, E>> graph_;
+};
+
+// Graph shared between many reader threads and writers, in the style of read-copy-update
+// Readers see immutable published versions of the graph and never wait for a writer
+// Each write copies the latest version, applies its changes and publishes the copy
+template <typename N, typename E>
+class SharedGraph {
+ public:
+  // Handle for one reader thread that keeps the version it last saw
+  // Checking for a newer version is one atomic load, so readers on different cores don't contend
+  class Reader {
+   public:
+    // Returns the latest published version
+    // The reference stays valid until the next call to Get on this reader
+    const Graph<N, E>& Get();
+
+   private:
+    explicit Reader(const SharedGraph* shared) : shared_{shared}, version_{0} {}
+    const SharedGraph* shared_;
+    std::shared_ptr<const Graph<N, E>> snapshot_;
+    std::uint64_t version_;
+
+    friend class SharedGraph;
+  };
+
+  // ----------------------- Constructors ----------------------------
+
+  // Constructor that publishes a graph as the first version
+  explicit SharedGraph(Graph<N, E> = {});
+
+  // ----------------------- Methods ----------------------------
+
+  // Method for getting a reader handle, which must not be shared between threads
+  Reader MakeReader() const { return Reader{this}; }
+
+  // Method for getting the latest published version, which stays valid for as long as it is held
+  std::shared_ptr<const Graph<N, E>> Snapshot() const;
+
+  // Method for getting the number of versions published since construction
+  std::uint64_t Version() const noexcept { return version_.load(std::memory_order_acquire); }
+
+  // Method for applying a function to a copy of the latest version and publishing the copy
+  // Writers are serialized with each other but not with readers, so batch changes in one call
+  // Nothing is published if the function throws
+  template <typename F>
+  void Write(F&&);
+
+ private:
+  std::mutex writer_;
+  std::shared_ptr<const Graph<N, E>> snapshot_;
+  std::atomic<std::uint64_t> version_;
+};
+
 #include "assignments/dg/graph.tpp"
 
 }  // namespace gdwg
@@ -1,317 +1,2023 @@
-// ----------------------- Constructors ----------------------------
-// Constructor that takes in vector of nodes
-template <typename N, typename E>
-Graph<N, E>::Graph(typename std::vector<N>::const_iterator begin,
-                   typename std::vector<N>::const_iterator end) {
-  while (begin != end) {
-    InsertNode(*begin);
-    begin++;
-  }
-}
-
-// Constructor that takes in a vector of tuples
-template <typename N, typename E>
-Graph<N, E>::Graph(typename std::vector<std::tuple<N, N, E>>::const_iterator begin,
-                   typename std::vector<std::tuple<N, N, E>>::const_iterator end) {
-  while (begin != end) {
-    InsertNode(std::get<0>(*begin));
-    InsertNode(std::get<1>(*begin));
-    InsertEdge(std::get<0>(*begin), std::get<1>(*begin), std::get<2>(*begin));
-    begin++;
-  }
-}
-
-// Constructor that takes in a initializer list of nodes
-template <typename N, typename E>
-Graph<N, E>::Graph(typename std::initializer_list<N> nodes) {
-  for (auto node : nodes)
-    InsertNode(node);
-}
-
-// Copy Constructor
-template <typename N, typename E>
-Graph<N, E>::Graph(const Graph& g) {
-  for (auto node : g.nodes_)
-    InsertNode(*node);
-  for (auto edge : g.edges_) {
-    shared_ptr<N> source = edge->source_.lock();
-    shared_ptr<N> destination = edge->destination_.lock();
-    InsertEdge(*source, *destination, edge->weight_);
-  }
-}
-
-// ----------------------- Operations ----------------------------
-// Copy Assignment Operator
-template <typename N, typename E>
-Graph<N, E>& Graph<N, E>::operator=(const Graph& g) noexcept {
-  for (auto node : g.nodes_)
-    InsertNode(*node);
-  for (auto edge : g.edges_) {
-    shared_ptr<N> source = edge->source_.lock();
-    shared_ptr<N> destination = edge->destination_.lock();
-    InsertEdge(*source, *destination, edge->weight_);
-  }
-
-  return *this;
-}
-
-// ----------------------- Methods ----------------------------
-// Check is a particular node is in the graph
-template <typename N, typename E>
-bool Graph<N, E>::IsNode(const N& val) const noexcept {
-  for (auto node : nodes_) {
-    if (*node == val)
-      return true;
-  }
-  return false;
-}
-
-// Inserts a node into the graph
-template <typename N, typename E>
-bool Graph<N, E>::InsertNode(const N& val) noexcept {
-  if (IsNode(val)) {
-    return false;
-  }
-  nodes_.push_back(std::make_shared<N>(val));
-  return true;
-}
-
-// Inserts an edge into the graph
-template <typename N, typename E>
-bool Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
-  if (isEdge(src, dst, w))
-    return false;
-  shared_ptr<N> source = getNode(src);
-  shared_ptr<N> destination = getNode(dst);
-  if (!source || !destination) {
-    throw std::runtime_error(
-        "Cannot call Graph::InsertEdge when either src or dst node does not exist");
-  }
-  edges_.insert(std::make_shared<Edge>(source, destination, w));
-
-  return true;
-}
-
-// Deletes a node from the graph
-template <typename N, typename E>
-bool Graph<N, E>::DeleteNode(const N& val) noexcept {
-  for (auto nodeItr = nodes_.begin(); nodeItr != nodes_.end(); nodeItr++) {
-    auto node = *nodeItr;
-    if (*node == val) {
-      // Remove from nodes
-      nodes_.erase(nodeItr);
-
-      // Remove its edges
-      for (auto edgeItr = edges_.begin(); edgeItr != edges_.end(); edgeItr++) {
-        auto edge = *edgeItr;
-        shared_ptr<N> source = edge->source_.lock();
-        shared_ptr<N> destination = edge->destination_.lock();
-        if (val == *source || val == *destination) {
-          edgeItr = edges_.erase(edgeItr);
-          edgeItr--;
-        }
-      }
-      return true;
-    }
-  }
-  return false;
-}
-
-// Replaces oldData by the newData
-template <typename N, typename E>
-bool Graph<N, E>::Replace(const N& oldData, const N& newData) {
-  // Check if oldData is present
-  if (!IsNode(oldData)) {
-    throw std::runtime_error("Cannot call Graph::Replace on a node that doesn't exist");
-  }
-
-  // Check if newData is present
-  if (IsNode(newData)) {
-    return false;
-  }
-
-  // Okay to change
-  auto changeNode = getNode(oldData);
-  *changeNode = newData;
-
-  return true;
-}
-
-// All instances of oldData is replaced by newData
-// Every incoming and outgoing edge of oldData becomes an incoming/ougoing edge of newData
-template <typename N, typename E>
-void Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
-  // Check if both nodes are present
-  if (!IsNode(oldData) || !IsNode(newData)) {
-    throw std::runtime_error(
-        "Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph");
-  }
-
-  // Change the edges
-  for (auto edgeItr = edges_.begin(); edgeItr != edges_.end();) {
-    auto edge = *edgeItr;
-    shared_ptr<N> source = edge->source_.lock();
-    shared_ptr<N> destination = edge->destination_.lock();
-
-    if (oldData == *source && oldData == *destination) {
-      // Delete the edge
-      edgeItr = edges_.erase(edgeItr);
-      // Add Edge if not already there
-      InsertEdge(newData, newData, edge->weight_);
-    } else if (oldData == *source) {
-      edgeItr = edges_.erase(edgeItr);
-      InsertEdge(newData, *destination, edge->weight_);
-    } else if (oldData == *destination) {
-      edgeItr = edges_.erase(edgeItr);
-      InsertEdge(*source, newData, edge->weight_);
-    } else {
-      edgeItr++;
-    }
-  }
-
-  // Remove the oldData Node
-  for (auto nodeItr = nodes_.begin(); nodeItr != nodes_.end(); nodeItr++) {
-    auto node = *nodeItr;
-    if (*node == oldData) {
-      // Remove from nodes
-      nodes_.erase(nodeItr);
-      break;
-    }
-  }
-}
-
-// Clears the entire graph
-template <typename N, typename E>
-void Graph<N, E>::Clear() noexcept {
-  nodes_.clear();
-  edges_.clear();
-}
-
-// Checks if 2 nodes are connected by an edge
-template <typename N, typename E>
-bool Graph<N, E>::IsConnected(const N& src, const N& dst) const {
-  if (!IsNode(src) || !IsNode(dst)) {
-    throw std::runtime_error(
-        "Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
-  }
-
-  for (auto edge : edges_) {
-    shared_ptr<N> source = edge->source_.lock();
-    shared_ptr<N> destination = edge->destination_.lock();
-    if (src == *source && dst == *destination)
-      return true;
-  }
-  return false;
-}
-
-// Gets all nodes of the graph
-template <typename N, typename E>
-std::vector<N> Graph<N, E>::GetNodes() const noexcept {
-  std::vector<N> results;
-  for (auto node : nodes_) {
-    results.push_back(*node);
-  }
-  std::sort(results.begin(), results.end());
-  return results;
-}
-
-// Gets all edges of a particular node
-template <typename N, typename E>
-std::vector<N> Graph<N, E>::GetConnected(const N& src) const {
-  if (!IsNode(src))
-    throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the graph");
-
-  std::vector<N> results;
-  for (auto edge : edges_) {
-    shared_ptr<N> source = edge->source_.lock();
-    shared_ptr<N> destination = edge->destination_.lock();
-    if (src == *source)
-      results.push_back(*destination);
-  }
-  std::sort(results.begin(), results.end());
-  return results;
-}
-
-// Get the weights of all edges connecting src and dst
-template <typename N, typename E>
-std::vector<E> Graph<N, E>::GetWeights(const N& src, const N& dst) const {
-  if (!IsNode(src) || !IsNode(dst)) {
-    throw std::runtime_error(
-        "Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
-  }
-
-  std::vector<E> results;
-  for (auto edge : edges_) {
-    shared_ptr<N> source = edge->source_.lock();
-    shared_ptr<N> destination = edge->destination_.lock();
-    if (src == *source && dst == *destination)
-      results.push_back(edge->weight_);
-  }
-  std::sort(results.begin(), results.end());
-  return results;
-}
-
-// Erases a edge from the graph
-template <typename N, typename E>
-bool Graph<N, E>::erase(const N& src, const N& dst, const E& w) noexcept {
-  for (auto edgeItr = edges_.begin(); edgeItr != edges_.end(); edgeItr++) {
-    auto edge = *edgeItr;
-    shared_ptr<N> source = edge->source_.lock();
-    shared_ptr<N> destination = edge->destination_.lock();
-    if (src == *source && dst == *destination && w == edge->weight_) {
-      edges_.erase(edgeItr);
-      return true;
-    }
-  }
-  return false;
-}
-
-// Finds a particular edge in the graph and returns it as an iterator
-template <typename N, typename E>
-typename Graph<N, E>::const_iterator Graph<N, E>::find(const N& src, const N& dst, const E& w) const
-    noexcept {
-  for (auto edgeItr = edges_.begin(); edgeItr != edges_.end(); edgeItr++) {
-    auto edge = *edgeItr;
-    shared_ptr<N> source = edge->source_.lock();
-    shared_ptr<N> destination = edge->destination_.lock();
-    if (src == *source && dst == *destination && w == edge->weight_) {
-      return {edgeItr, edges_.cbegin(), edges_.cend()};
-    }
-  }
-  return {edges_.cend(), edges_.cbegin(), edges_.cend()};
-}
-
-// Erases an edge from the graph and returns an iterator to the next edge
-template <typename N, typename E>
-typename Graph<N, E>::const_iterator Graph<N, E>::erase(const_iterator it) noexcept {
-  for (auto edgeItr = edges_.begin(); edgeItr != edges_.end(); edgeItr++) {
-    if (edgeItr == it.edge_itr_) {
-      edgeItr = edges_.erase(edgeItr);
-      return {edgeItr, edges_.cbegin(), edges_.cend()};
-    }
-  }
-  return {edges_.cend(), edges_.cbegin(), edges_.cend()};
-}
-
-// ----------------------- Helper Functions ----------------------------
-// Returns a shared_ptr to a particular node
-template <typename N, typename E>
-shared_ptr<N> Graph<N, E>::getNode(const N& val) const noexcept {
-  for (auto node : nodes_) {
-    if (*node == val)
-      return node;
-  }
-  return nullptr;
-}
-
-// Returhs true if there is an edge from src to dst with weight w
-template <typename N, typename E>
-bool Graph<N, E>::isEdge(const N& src, const N& dst, const E& w) const noexcept {
-  for (auto edge : edges_) {
-    shared_ptr<N> source = edge->source_.lock();
-    shared_ptr<N> destination = edge->destination_.lock();
-    if (src == *source && dst == *destination && w == edge->weight_)
-      return true;
-  }
-  return false;
-}
+// ----------------------- Constructors ----------------------------
+// Constructor that takes in the memory resource to allocate from
+template <typename N, typename E>
+Graph<N, E>::Graph(std::pmr::memory_resource* resource)
+  : resource_{statsResource(resource)}, nodes_{resource_}, edges_{resource_}, slots_{resource_},
+    freeSlots_{resource_} {}
+
+// Constructor that takes in a list of nodes or a list of edge tuples
+template <typename N, typename E>
+template <typename InputIt, typename>
+Graph<N, E>::Graph(InputIt begin, InputIt end, std::pmr::memory_resource* resource)
+  : Graph(resource) {
+  if constexpr (std::is_convertible<typename std::iterator_traits<InputIt>::reference, N>::value) {
+    while (begin != end) {
+      findOrInsertNode(*begin);
+      begin++;
+    }
+  } else {
+    std::vector<std::tuple<N, N, E>> edges;
+    if constexpr (std::is_base_of<std::forward_iterator_tag,
+                                  typename std::iterator_traits<InputIt>::iterator_category>::value)
+      edges.reserve(std::distance(begin, end));
+    while (begin != end) {
+      edges.emplace_back(*begin);
+      begin++;
+    }
+    bulkLoad(std::move(edges));
+  }
+}
+
+// Constructor that takes in a range of nodes or edge tuples
+template <typename N, typename E>
+template <typename Range, typename>
+Graph<N, E>::Graph(Range&& range, std::pmr::memory_resource* resource)
+  : Graph(rangeBegin(std::forward<Range>(range)), rangeEnd(std::forward<Range>(range)), resource) {
+}
+
+// Constructor that takes in a initializer list of nodes
+template <typename N, typename E>
+Graph<N, E>::Graph(typename std::initializer_list<N> nodes, std::pmr::memory_resource* resource)
+  : Graph(resource) {
+  for (auto node : nodes)
+    InsertNode(node);
+}
+
+// Copy Constructor
+// Like the standard containers, a copy allocates from the default resource
+template <typename N, typename E>
+Graph<N, E>::Graph(const Graph& g) : Graph() {
+  StatsScope scope{GraphMethod::Copy};
+  cloneFrom(g);
+}
+
+// ----------------------- Operations ----------------------------
+// Copy Assignment Operator
+// The graph is replaced by a clone of the other graph, as with move assignment
+template <typename N, typename E>
+Graph<N, E>& Graph<N, E>::operator=(const Graph& g) noexcept {
+  StatsScope scope{GraphMethod::Copy};
+  if (this == &g)
+    return *this;
+
+  Clear();
+  cloneFrom(g);
+  return *this;
+}
+
+// Move Assignment Operator
+// Storage can only be taken over when both graphs allocate from the same resource
+template <typename N, typename E>
+Graph<N, E>& Graph<N, E>::operator=(Graph&& g) noexcept {
+  if (this == &g)
+    return *this;
+
+  Clear();
+  if (resource_ == g.resource_) {
+    edges_ = std::move(g.edges_);
+    nodes_ = std::move(g.nodes_);
+    slots_ = std::move(g.slots_);
+    freeSlots_ = std::move(g.freeSlots_);
+  } else {
+    *this = g;
+  }
+  g.Clear();
+
+  return *this;
+}
+
+// ----------------------- Methods ----------------------------
+// Check is a particular node is in the graph
+template <typename N, typename E>
+bool Graph<N, E>::IsNode(const N& val) const noexcept {
+  StatsScope scope{GraphMethod::IsNode};
+  return nodes_.find(val) != nodes_.end();
+}
+
+// Inserts a node into the graph
+template <typename N, typename E>
+bool Graph<N, E>::InsertNode(const N& val) noexcept {
+  StatsScope scope{GraphMethod::InsertNode};
+  return insertNode(val);
+}
+
+// Inserts a node into the graph by moving the value in
+template <typename N, typename E>
+bool Graph<N, E>::InsertNode(N&& val) noexcept {
+  StatsScope scope{GraphMethod::InsertNode};
+  return insertNode(std::move(val));
+}
+
+// Constructs a node in place and inserts it into the graph
+template <typename N, typename E>
+template <typename... Args>
+bool Graph<N, E>::EmplaceNode(Args&&... args) {
+  StatsScope scope{GraphMethod::EmplaceNode};
+  auto node = makeNode(std::forward<Args>(args)...);
+  if (IsNode(node->value_))
+    return false;
+  indexNode(std::move(node));
+  return true;
+}
+
+// Gets the handle of a node, inserting the node first if needed
+template <typename N, typename E>
+NodeId Graph<N, E>::InsertNodeId(const N& val) {
+  StatsScope scope{GraphMethod::InsertNodeId};
+  return idOf(*findOrInsertNode(val));
+}
+
+// Gets the handle of a node, moving the value in if the node is inserted
+template <typename N, typename E>
+NodeId Graph<N, E>::InsertNodeId(N&& val) {
+  StatsScope scope{GraphMethod::InsertNodeId};
+  return idOf(*findOrInsertNode(std::move(val)));
+}
+
+// Gets the handle of a node in the graph
+template <typename N, typename E>
+NodeId Graph<N, E>::GetNodeId(const N& val) const {
+  StatsScope scope{GraphMethod::GetNodeId};
+  auto nodeItr = nodes_.find(val);
+  if (nodeItr == nodes_.end())
+    throw std::out_of_range("Cannot call Graph::GetNodeId if the node doesn't exist in the graph");
+  return idOf(*nodeItr->second);
+}
+
+// Checks if a handle refers to a node of the graph
+template <typename N, typename E>
+bool Graph<N, E>::IsNode(NodeId id) const noexcept {
+  StatsScope scope{GraphMethod::IsNode};
+  return nodeOf(id) != nullptr;
+}
+
+// Gets the value of the node a handle refers to
+template <typename N, typename E>
+const N& Graph<N, E>::GetNode(NodeId id) const {
+  StatsScope scope{GraphMethod::GetNode};
+  auto node = nodeOf(id);
+  if (!node)
+    throw std::out_of_range("Cannot call Graph::GetNode with a NodeId that is not valid");
+  return node->value_;
+}
+
+// Inserts an edge between the nodes two handles refer to
+template <typename N, typename E>
+bool Graph<N, E>::InsertEdge(NodeId src, NodeId dst, const E& w) {
+  StatsScope scope{GraphMethod::InsertEdge};
+  auto source = nodeOf(src);
+  auto destination = nodeOf(dst);
+  if (!source || !destination) {
+    throw std::runtime_error(
+        "Cannot call Graph::InsertEdge when either src or dst node does not exist");
+  }
+  return insertEdgeBetween(source, destination, w);
+}
+
+// Inserts an edge between the nodes two handles refer to by moving the weight in
+template <typename N, typename E>
+bool Graph<N, E>::InsertEdge(NodeId src, NodeId dst, E&& w) {
+  StatsScope scope{GraphMethod::InsertEdge};
+  auto source = nodeOf(src);
+  auto destination = nodeOf(dst);
+  if (!source || !destination) {
+    throw std::runtime_error(
+        "Cannot call Graph::InsertEdge when either src or dst node does not exist");
+  }
+  return insertEdgeBetween(source, destination, std::move(w));
+}
+
+// Checks if 2 nodes are connected by an edge, searching the shorter of their adjacency lists
+// Every edge in those lists has the same node at the same address, so that node is never compared
+template <typename N, typename E>
+bool Graph<N, E>::IsConnected(NodeId src, NodeId dst) const {
+  StatsScope scope{GraphMethod::IsConnected};
+  auto source = nodeOf(src);
+  auto destination = nodeOf(dst);
+  if (!source || !destination) {
+    throw std::runtime_error(
+        "Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
+  }
+
+  const EdgeRefs& edges =
+      source->out_.size() <= destination->in_.size() ? source->out_ : destination->in_;
+  return edges.find(EdgeKey{source->value_, destination->value_, nullptr}) != edges.end();
+}
+
+// Gets the handles of all the nodes connected to a node
+template <typename N, typename E>
+std::vector<NodeId> Graph<N, E>::GetConnected(NodeId src) const {
+  StatsScope scope{GraphMethod::GetConnected};
+  auto source = nodeOf(src);
+  if (!source)
+    throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the graph");
+
+  countEdgesScanned(GraphMethod::GetConnected, source->out_.size());
+  std::vector<NodeId> results;
+  results.reserve(source->out_.size());
+  for (const Edge* edge : source->out_)
+    results.push_back(idOf(*edge->destination_));
+  return results;
+}
+
+// Gets the weights of all the edges between the nodes two handles refer to
+template <typename N, typename E>
+std::vector<E> Graph<N, E>::GetWeights(NodeId src, NodeId dst) const {
+  StatsScope scope{GraphMethod::GetWeights};
+  auto source = nodeOf(src);
+  auto destination = nodeOf(dst);
+  if (!source || !destination) {
+    throw std::runtime_error(
+        "Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
+  }
+
+  std::vector<E> results;
+  auto range = source->out_.equal_range(EdgeKey{source->value_, destination->value_, nullptr});
+  for (auto edgeItr = range.first; edgeItr != range.second; edgeItr++)
+    results.push_back((*edgeItr)->weight_);
+  countEdgesScanned(GraphMethod::GetWeights, results.size());
+  return results;
+}
+
+// Erases the edge between the nodes two handles refer to
+template <typename N, typename E>
+bool Graph<N, E>::erase(NodeId src, NodeId dst, const E& w) noexcept {
+  StatsScope scope{GraphMethod::erase};
+  auto source = nodeOf(src);
+  auto destination = nodeOf(dst);
+  if (!source || !destination)
+    return false;
+
+  auto edgeItr = edges_.find(EdgeKey{source->value_, destination->value_, &w});
+  if (edgeItr == edges_.end())
+    return false;
+  unlinkEdge(*edgeItr);
+  return true;
+}
+
+// Inserts an edge into the graph
+template <typename N, typename E>
+bool Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
+  StatsScope scope{GraphMethod::InsertEdge};
+  return insertEdge(src, dst, w);
+}
+
+// Inserts an edge into the graph by moving the weight in
+template <typename N, typename E>
+bool Graph<N, E>::InsertEdge(const N& src, const N& dst, E&& w) {
+  StatsScope scope{GraphMethod::InsertEdge};
+  return insertEdge(src, dst, std::move(w));
+}
+
+// Deletes a node from the graph
+template <typename N, typename E>
+bool Graph<N, E>::DeleteNode(const N& val) noexcept {
+  StatsScope scope{GraphMethod::DeleteNode};
+  auto nodeItr = nodes_.find(val);
+  if (nodeItr == nodes_.end())
+    return false;
+
+  // Remove its edges and then the node itself
+  countEdgesScanned(GraphMethod::DeleteNode, unlinkIncidentEdges(*nodeItr->second).size());
+  eraseNode(nodeItr);
+  return true;
+}
+
+// Replaces oldData by the newData
+template <typename N, typename E>
+bool Graph<N, E>::Replace(const N& oldData, const N& newData) {
+  StatsScope scope{GraphMethod::Replace};
+  return replace(oldData, newData);
+}
+
+// Replaces oldData by the newData by moving the new value in
+template <typename N, typename E>
+bool Graph<N, E>::Replace(const N& oldData, N&& newData) {
+  StatsScope scope{GraphMethod::Replace};
+  return replace(oldData, std::move(newData));
+}
+
+// All instances of oldData is replaced by newData
+// Every incoming and outgoing edge of oldData becomes an incoming/ougoing edge of newData
+// The edges are re-keyed and relinked in O(deg log E) without reallocating them
+template <typename N, typename E>
+void Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
+  StatsScope scope{GraphMethod::MergeReplace};
+  // Check if both nodes are present
+  auto nodeItr = nodes_.find(oldData);
+  auto newItr = nodes_.find(newData);
+  if (nodeItr == nodes_.end() || newItr == nodes_.end()) {
+    throw std::runtime_error(
+        "Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph");
+  }
+
+  // Merging a node into itself leaves it as it is
+  Node* oldNode = nodeItr->second.get();
+  Node* newNode = newItr->second.get();
+  if (oldNode == newNode)
+    return;
+
+  // Change the edges - an edge that newData already has is dropped along with its handle
+  auto edges = unlinkIncidentEdges(*oldNode);
+  countEdgesScanned(GraphMethod::MergeReplace, edges.size());
+  for (auto& handle : edges) {
+    Edge& edge = handle.value();
+    if (edge.source_ == oldNode)
+      edge.source_ = newNode;
+    if (edge.destination_ == oldNode)
+      edge.destination_ = newNode;
+    linkEdge(std::move(handle));
+  }
+
+  // Remove the oldData Node
+  eraseNode(nodeItr);
+}
+
+// Clears the entire graph
+template <typename N, typename E>
+void Graph<N, E>::Clear() noexcept {
+  StatsScope scope{GraphMethod::Clear};
+  countEdgesScanned(GraphMethod::Clear, edges_.size());
+  edges_.clear();
+  for (const auto& node : nodes_)
+    releaseSlot(*node.second);
+  nodes_.clear();
+}
+
+// Checks if 2 nodes are connected by an edge
+template <typename N, typename E>
+bool Graph<N, E>::IsConnected(const N& src, const N& dst) const {
+  StatsScope scope{GraphMethod::IsConnected};
+  auto source = nodes_.find(src);
+  if (source == nodes_.end() || !IsNode(dst)) {
+    throw std::runtime_error(
+        "Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
+  }
+
+  const EdgeRefs& edges = source->second->out_;
+  return edges.find(EdgeKey{src, dst, nullptr}) != edges.end();
+}
+
+// Gets all nodes of the graph
+template <typename N, typename E>
+std::vector<N> Graph<N, E>::GetNodes() const noexcept {
+  StatsScope scope{GraphMethod::GetNodes};
+  std::vector<N> results;
+  results.reserve(nodes_.size());
+  for (const auto& node : nodes_) {
+    results.push_back(node.second->value_);
+  }
+  std::sort(results.begin(), results.end());
+  return results;
+}
+
+// Gets all edges of a particular node
+// Outgoing edges are already sorted by destination
+template <typename N, typename E>
+std::vector<N> Graph<N, E>::GetConnected(const N& src) const {
+  StatsScope scope{GraphMethod::GetConnected};
+  auto source = nodes_.find(src);
+  if (source == nodes_.end())
+    throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the graph");
+
+  countEdgesScanned(GraphMethod::GetConnected, source->second->out_.size());
+  std::vector<N> results;
+  results.reserve(source->second->out_.size());
+  for (const Edge* edge : source->second->out_) {
+    results.push_back(edge->destination_->value_);
+  }
+  return results;
+}
+
+// Get the weights of all edges connecting src and dst
+// Edges between the same nodes are already sorted by weight
+template <typename N, typename E>
+std::vector<E> Graph<N, E>::GetWeights(const N& src, const N& dst) const {
+  StatsScope scope{GraphMethod::GetWeights};
+  auto source = nodes_.find(src);
+  if (source == nodes_.end() || !IsNode(dst)) {
+    throw std::runtime_error(
+        "Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
+  }
+
+  std::vector<E> results;
+  auto range = source->second->out_.equal_range(EdgeKey{src, dst, nullptr});
+  for (auto edgeItr = range.first; edgeItr != range.second; edgeItr++)
+    results.push_back((*edgeItr)->weight_);
+  countEdgesScanned(GraphMethod::GetWeights, results.size());
+  return results;
+}
+
+// Gets the distance to every node reachable from src
+template <typename N, typename E>
+std::vector<std::pair<N, E>> Graph<N, E>::ShortestPaths(const N& src) const {
+  StatsScope scope{GraphMethod::ShortestPaths};
+  auto source = nodes_.find(src);
+  if (source == nodes_.end())
+    throw std::out_of_range("Cannot call Graph::ShortestPaths if src doesn't exist in the graph");
+
+  auto labels = dijkstra(*source->second, nullptr);
+  std::vector<std::pair<N, E>> results;
+  results.reserve(labels.size());
+  for (const auto& [node, label] : labels)
+    results.emplace_back(node->value_, label.distance_);
+  std::sort(results.begin(), results.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  return results;
+}
+
+// Gets the shortest path from src to dst, only searching until dst is settled
+template <typename N, typename E>
+std::optional<std::pair<E, std::vector<N>>> Graph<N, E>::ShortestPath(const N& src,
+                                                                      const N& dst) const {
+  StatsScope scope{GraphMethod::ShortestPath};
+  auto source = nodes_.find(src);
+  auto destination = nodes_.find(dst);
+  if (source == nodes_.end() || destination == nodes_.end()) {
+    throw std::out_of_range(
+        "Cannot call Graph::ShortestPath if src or dst node don't exist in the graph");
+  }
+
+  auto labels = dijkstra(*source->second, destination->second.get());
+  auto labelItr = labels.find(destination->second.get());
+  if (labelItr == labels.end() || !labelItr->second.settled_)
+    return std::nullopt;
+
+  // Walk back along the parents and then reverse them into path order
+  std::vector<N> path;
+  for (const Node* node = labelItr->first; node; node = labels.at(node).parent_)
+    path.push_back(node->value_);
+  std::reverse(path.begin(), path.end());
+  return std::make_pair(labelItr->second.distance_, std::move(path));
+}
+
+// Erases a edge from the graph
+template <typename N, typename E>
+bool Graph<N, E>::erase(const N& src, const N& dst, const E& w) noexcept {
+  StatsScope scope{GraphMethod::erase};
+  auto edgeItr = edges_.find(EdgeKey{src, dst, &w});
+  if (edgeItr == edges_.end())
+    return false;
+  unlinkEdge(*edgeItr);
+  return true;
+}
+
+// Inserts a batch of edges in edge order
+template <typename N, typename E>
+template <typename Range>
+std::vector<BatchResult> Graph<N, E>::InsertEdges(Range&& range) {
+  StatsScope scope{GraphMethod::InsertEdges};
+  std::vector<std::tuple<N, N, E>> edges{rangeBegin(std::forward<Range>(range)),
+                                         rangeEnd(std::forward<Range>(range))};
+  std::vector<BatchResult> results(edges.size());
+  const N* lastSrc = nullptr;
+  Node* source = nullptr;
+  for (auto i : sortedOrder(edges)) {
+    auto& [src, dst, w] = edges[i];
+    if (!lastSrc || !(*lastSrc == src)) {
+      auto sourceItr = nodes_.find(src);
+      source = sourceItr == nodes_.end() ? nullptr : sourceItr->second.get();
+      lastSrc = &src;
+    }
+    auto destinationItr = nodes_.find(dst);
+    if (!source || destinationItr == nodes_.end()) {
+      results[i] = BatchResult::MissingNode;
+      continue;
+    }
+
+    results[i] = insertEdgeBetween(source, destinationItr->second.get(), std::move(w))
+                     ? BatchResult::Inserted
+                     : BatchResult::Duplicate;
+  }
+  return results;
+}
+
+// Erases a batch of edges in edge order
+template <typename N, typename E>
+template <typename Range>
+std::vector<BatchResult> Graph<N, E>::EraseEdges(Range&& range) {
+  StatsScope scope{GraphMethod::EraseEdges};
+  std::vector<std::tuple<N, N, E>> edges{rangeBegin(std::forward<Range>(range)),
+                                         rangeEnd(std::forward<Range>(range))};
+  std::vector<BatchResult> results(edges.size());
+  for (auto i : sortedOrder(edges)) {
+    const auto& [src, dst, w] = edges[i];
+    auto edgeItr = edges_.find(EdgeKey{src, dst, &w});
+    if (edgeItr == edges_.end()) {
+      results[i] = BatchResult::Missing;
+      continue;
+    }
+    unlinkEdge(*edgeItr);
+    results[i] = BatchResult::Erased;
+  }
+  return results;
+}
+
+// Deletes a batch of nodes, each in O(deg)
+template <typename N, typename E>
+template <typename Range>
+std::vector<BatchResult> Graph<N, E>::DeleteNodes(Range&& range) {
+  StatsScope scope{GraphMethod::DeleteNodes};
+  std::vector<BatchResult> results;
+  for (const auto& val : range)
+    results.push_back(DeleteNode(val) ? BatchResult::Deleted : BatchResult::Missing);
+  return results;
+}
+
+// Finds a particular edge in the graph and returns it as an iterator
+template <typename N, typename E>
+typename Graph<N, E>::const_iterator Graph<N, E>::find(const N& src, const N& dst, const E& w) const
+    noexcept {
+  StatsScope scope{GraphMethod::find};
+  return {edges_.find(EdgeKey{src, dst, &w}), edges_.cbegin(), edges_.cend()};
+}
+
+// Erases an edge from the graph and returns an iterator to the next edge
+template <typename N, typename E>
+typename Graph<N, E>::const_iterator Graph<N, E>::erase(const_iterator it) noexcept {
+  StatsScope scope{GraphMethod::erase};
+  for (auto edgeItr = edges_.begin(); edgeItr != edges_.end(); edgeItr++) {
+    countEdgesScanned(GraphMethod::erase, 1);
+    if (edgeItr == it.edge_itr_) {
+      auto next = std::next(edgeItr);
+      unlinkEdge(*edgeItr);
+      return {next, edges_.cbegin(), edges_.cend()};
+    }
+  }
+  return {edges_.cend(), edges_.cbegin(), edges_.cend()};
+}
+
+// Compacts the graph into a compressed sparse row snapshot
+// Outgoing edges are already in (destination, weight) order, so each row is copied as is
+template <typename N, typename E>
+FrozenGraph<N, E> Graph<N, E>::Freeze() const {
+  StatsScope scope{GraphMethod::Freeze};
+  countEdgesScanned(GraphMethod::Freeze, edges_.size());
+  std::vector<const Node*> nodes;
+  nodes.reserve(nodes_.size());
+  for (const auto& node : nodes_)
+    nodes.push_back(node.second.get());
+  std::sort(nodes.begin(), nodes.end(),
+            [](const Node* a, const Node* b) -> bool { return a->value_ < b->value_; });
+
+  std::unordered_map<const Node*, std::size_t> rows;
+  std::vector<N> values;
+  rows.reserve(nodes.size());
+  values.reserve(nodes.size());
+  for (const Node* node : nodes) {
+    rows.emplace(node, values.size());
+    values.push_back(node->value_);
+  }
+
+  std::vector<std::size_t> offsets;
+  std::vector<std::size_t> destinations;
+  std::vector<E> weights;
+  offsets.reserve(nodes.size() + 1);
+  destinations.reserve(edges_.size());
+  weights.reserve(edges_.size());
+  offsets.push_back(0);
+  for (const Node* node : nodes) {
+    for (const Edge* edge : node->out_) {
+      destinations.push_back(rows.find(edge->destination_)->second);
+      weights.push_back(edge->weight_);
+    }
+    offsets.push_back(weights.size());
+  }
+
+  return FrozenGraph<N, E>{typename FrozenGraph<N, E>::Arrays{
+      std::move(values), std::move(offsets), std::move(destinations), std::move(weights)}};
+}
+
+// Writes the graph to a file as a frozen snapshot
+template <typename N, typename E>
+void Graph<N, E>::Save(const std::string& path) const {
+  Freeze().Save(path);
+}
+
+// Reads a graph from a file written by Save
+// The saved edges are already sorted, so they are bulk loaded straight from the snapshot
+template <typename N, typename E>
+Graph<N, E> Graph<N, E>::Load(const std::string& path) {
+  auto frozen = FrozenGraph<N, E>::Load(path);
+  Graph g{frozen.cbegin(), frozen.cend()};
+  for (std::size_t node = 0; node < frozen.nodeCount_; node++)
+    g.findOrInsertNode(frozen.nodes_[node]);
+  return g;
+}
+
+// Ranks the nodes on a snapshot, where the edges are contiguous
+template <typename N, typename E>
+std::vector<std::pair<N, double>> Graph<N, E>::PageRank(double damping,
+                                                        double tolerance,
+                                                        std::size_t maxIterations,
+                                                        std::size_t threads) const {
+  return Freeze().PageRank(damping, tolerance, maxIterations, threads);
+}
+
+// Ranks the nodes by their weighted edges on a snapshot
+template <typename N, typename E>
+std::vector<std::pair<N, double>> Graph<N, E>::WeightedPageRank(double damping,
+                                                                double tolerance,
+                                                                std::size_t maxIterations,
+                                                                std::size_t threads) const {
+  return Freeze().WeightedPageRank(damping, tolerance, maxIterations, threads);
+}
+
+// Finds the strongly connected components on a snapshot
+template <typename N, typename E>
+std::vector<std::pair<N, std::size_t>> Graph<N, E>::StronglyConnectedComponents() const {
+  return Freeze().StronglyConnectedComponents();
+}
+
+// Finds the weakly connected components on a snapshot
+template <typename N, typename E>
+std::vector<std::pair<N, std::size_t>> Graph<N, E>::WeaklyConnectedComponents(
+    std::size_t threads) const {
+  return Freeze().WeaklyConnectedComponents(threads);
+}
+
+// Streams in a graph from an input stream
+template <typename N, typename E>
+Graph<N, E> Graph<N, E>::ReadEdgeList(std::istream& is, std::pmr::memory_resource* resource) {
+  return readEdgeList(
+      [&is](char* buffer, std::size_t size) -> std::size_t {
+        is.read(buffer, size);
+        if (is.bad())
+          throw std::runtime_error(
+              "Cannot call Graph::ReadEdgeList on a stream that can't be read");
+        return is.gcount();
+      },
+      resource);
+}
+
+// Streams in a graph from a file descriptor
+template <typename N, typename E>
+Graph<N, E> Graph<N, E>::ReadEdgeList(int fd, std::pmr::memory_resource* resource) {
+  return readEdgeList(
+      [fd](char* buffer, std::size_t size) -> std::size_t {
+        ssize_t count;
+        do {
+          count = ::read(fd, buffer, size);
+        } while (count < 0 && errno == EINTR);
+        if (count < 0)
+          throw std::runtime_error("Cannot call Graph::ReadEdgeList on a file that can't be read");
+        return count;
+      },
+      resource);
+}
+
+// Reads the counters of every graph of this type
+template <typename N, typename E>
+GraphStats Graph<N, E>::Stats() noexcept {
+  GraphStats stats;
+  if constexpr (statsEnabled) {
+    stats.nodeComparisons_ = stats_.nodeComparisons_.load(std::memory_order_relaxed);
+    stats.edgeComparisons_ = stats_.edgeComparisons_.load(std::memory_order_relaxed);
+    stats.allocations_ = stats_.allocations_.load(std::memory_order_relaxed);
+    stats.bytesAllocated_ = stats_.bytesAllocated_.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < graphMethodCount; i++) {
+      const auto& counters = stats_.methods_[i];
+      auto& method = stats.methods_[i];
+      method.calls_ = counters.calls_.load(std::memory_order_relaxed);
+      method.edgesScanned_ = counters.edgesScanned_.load(std::memory_order_relaxed);
+      for (std::size_t bucket = 0; bucket < GraphStats::latencyBuckets; bucket++)
+        method.latency_[bucket] = counters.latency_[bucket].load(std::memory_order_relaxed);
+    }
+  }
+  return stats;
+}
+
+// Resets the counters of every graph of this type to zero
+template <typename N, typename E>
+void Graph<N, E>::ResetStats() noexcept {
+  if constexpr (statsEnabled) {
+    stats_.nodeComparisons_.store(0, std::memory_order_relaxed);
+    stats_.edgeComparisons_.store(0, std::memory_order_relaxed);
+    stats_.allocations_.store(0, std::memory_order_relaxed);
+    stats_.bytesAllocated_.store(0, std::memory_order_relaxed);
+    for (auto& counters : stats_.methods_) {
+      counters.calls_.store(0, std::memory_order_relaxed);
+      counters.edgesScanned_.store(0, std::memory_order_relaxed);
+      for (auto& bucket : counters.latency_)
+        bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+// ----------------------- Helper Functions ----------------------------
+// Returns a pointer to the stored value of a particular node
+template <typename N, typename E>
+const N* Graph<N, E>::getNode(const N& val) const noexcept {
+  auto nodeItr = nodes_.find(val);
+  if (nodeItr == nodes_.end())
+    return nullptr;
+  return &nodeItr->second->value_;
+}
+
+// Inserts a node into the graph, copying or moving the value in
+template <typename N, typename E>
+template <typename T>
+bool Graph<N, E>::insertNode(T&& val) {
+  if (IsNode(val)) {
+    return false;
+  }
+  indexNode(makeNode(std::forward<T>(val)));
+  return true;
+}
+
+// Inserts an edge into the graph, copying or moving the weight in
+template <typename N, typename E>
+template <typename W>
+bool Graph<N, E>::insertEdge(const N& src, const N& dst, W&& w) {
+  auto source = nodes_.find(src);
+  auto destination = nodes_.find(dst);
+  if (source == nodes_.end() || destination == nodes_.end()) {
+    throw std::runtime_error(
+        "Cannot call Graph::InsertEdge when either src or dst node does not exist");
+  }
+  return insertEdgeBetween(source->second.get(), destination->second.get(), std::forward<W>(w));
+}
+
+// Inserts an edge between two nodes
+// The lower bound of the edge both checks for a duplicate and is the hint to insert at
+template <typename N, typename E>
+template <typename W>
+bool Graph<N, E>::insertEdgeBetween(Node* source, Node* destination, W&& w) {
+  EdgeKey key{source->value_, destination->value_, &w};
+  auto edgeItr = edges_.lower_bound(key);
+  if (edgeItr != edges_.end() && !sortEdges::less(key, sortEdges::key(*edgeItr)))
+    return false;
+  edgeItr = edges_.emplace_hint(edgeItr, source, destination, std::forward<W>(w));
+  linkAdjacency(*edgeItr);
+  return true;
+}
+
+// Adds a new node to the index and gives it a slot
+// Everything that can throw happens before the slot is taken
+template <typename N, typename E>
+typename Graph<N, E>::Node* Graph<N, E>::indexNode(NodePtr node) {
+  if (freeSlots_.empty()) {
+    if (freeSlots_.capacity() <= slots_.size())
+      freeSlots_.reserve(2 * (slots_.size() + 1));
+    slots_.push_back(Slot{nullptr, 1});
+    freeSlots_.push_back(slots_.size() - 1);
+  }
+
+  Node* result = node.get();
+  nodes_.emplace(result->value_, std::move(node));
+  result->slot_ = freeSlots_.back();
+  freeSlots_.pop_back();
+  slots_[result->slot_].node_ = result;
+  return result;
+}
+
+// Removes a node from the index, which destroys it, and frees its slot
+template <typename N, typename E>
+void Graph<N, E>::eraseNode(typename NodeIndex::iterator nodeItr) noexcept {
+  releaseSlot(*nodeItr->second);
+  nodes_.erase(nodeItr);
+}
+
+// Frees the slot of a node, so that every handle to the node is no longer valid
+// The free list has room for every slot, so this never allocates
+template <typename N, typename E>
+void Graph<N, E>::releaseSlot(const Node& node) noexcept {
+  auto& slot = slots_[node.slot_];
+  slot.node_ = nullptr;
+  if (++slot.generation_ == 0)
+    slot.generation_ = 1;
+  freeSlots_.push_back(node.slot_);
+}
+
+// Finds the node a handle refers to
+template <typename N, typename E>
+typename Graph<N, E>::Node* Graph<N, E>::nodeOf(NodeId id) const noexcept {
+  if (id.slot_ >= slots_.size() || slots_[id.slot_].generation_ != id.generation_)
+    return nullptr;
+  return slots_[id.slot_].node_;
+}
+
+// Makes the handle for a node
+template <typename N, typename E>
+NodeId Graph<N, E>::idOf(const Node& node) const noexcept {
+  return NodeId{node.slot_, slots_[node.slot_].generation_};
+}
+
+// Replaces oldData by newData, copying or moving the new value in
+template <typename N, typename E>
+template <typename T>
+bool Graph<N, E>::replace(const N& oldData, T&& newData) {
+  // Check if oldData is present
+  auto nodeItr = nodes_.find(oldData);
+  if (nodeItr == nodes_.end()) {
+    throw std::runtime_error("Cannot call Graph::Replace on a node that doesn't exist");
+  }
+
+  // Check if newData is present
+  if (IsNode(newData)) {
+    return false;
+  }
+
+  // Edges are ordered by node value so the edges of oldData are re-keyed around the update
+  auto edges = unlinkIncidentEdges(*nodeItr->second);
+  countEdgesScanned(GraphMethod::Replace, edges.size());
+
+  // Okay to change - the node is re-keyed in the index around the update
+  auto handle = nodes_.extract(nodeItr);
+  handle.mapped()->value_ = std::forward<T>(newData);
+  nodes_.insert(std::move(handle));
+  for (auto& edge : edges)
+    linkEdge(std::move(edge));
+
+  return true;
+}
+
+// Clones another graph into this empty one in O(V + E)
+// Edges are copied in order with their nodes remapped, so every edge and adjacency insert is at
+// the end of its set and no node value is looked up
+template <typename N, typename E>
+void Graph<N, E>::cloneFrom(const Graph& g) {
+  countEdgesScanned(GraphMethod::Copy, g.edges_.size());
+  std::unordered_map<const Node*, Node*> clones;
+  clones.reserve(g.nodes_.size());
+  if constexpr (isHashable<N>::value)
+    nodes_.reserve(g.nodes_.size());
+  // Slots are copied as they are, so handles to the other graph's nodes work on the clone
+  slots_.assign(g.slots_.begin(), g.slots_.end());
+  freeSlots_.reserve(std::max(slots_.size(), g.freeSlots_.capacity()));
+  freeSlots_.assign(g.freeSlots_.begin(), g.freeSlots_.end());
+  for (const auto& node : g.nodes_) {
+    auto clone = makeNode(node.second->value_);
+    clone->slot_ = node.second->slot_;
+    slots_[clone->slot_].node_ = clone.get();
+    clones.emplace(node.second.get(), clone.get());
+    nodes_.emplace_hint(nodes_.end(), clone->value_, std::move(clone));
+  }
+
+  for (const Edge& edge : g.edges_) {
+    Node* source = clones.find(edge.source_)->second;
+    Node* destination = clones.find(edge.destination_)->second;
+    auto edgeItr = edges_.emplace_hint(edges_.end(), source, destination, edge.weight_);
+    source->out_.emplace_hint(source->out_.end(), &*edgeItr);
+    destination->in_.emplace_hint(destination->in_.end(), &*edgeItr);
+  }
+}
+
+// Allocates a node from the graph's memory resource and constructs its value in place
+template <typename N, typename E>
+template <typename... Args>
+typename Graph<N, E>::NodePtr Graph<N, E>::makeNode(Args&&... args) {
+  void* memory = resource_->allocate(sizeof(Node), alignof(Node));
+  try {
+    Node* node = new (memory) Node{resource_, std::forward<Args>(args)...};
+    return NodePtr{node, NodeDeleter{resource_}};
+  } catch (...) {
+    resource_->deallocate(memory, sizeof(Node), alignof(Node));
+    throw;
+  }
+}
+
+// Returns the node holding val, inserting a new node for it if there is none
+template <typename N, typename E>
+template <typename T>
+typename Graph<N, E>::Node* Graph<N, E>::findOrInsertNode(T&& val) {
+  auto nodeItr = nodes_.find(val);
+  if (nodeItr != nodes_.end())
+    return nodeItr->second.get();
+
+  return indexNode(makeNode(std::forward<T>(val)));
+}
+
+// Loads a batch of edges in O(E log E)
+template <typename N, typename E>
+void Graph<N, E>::bulkLoad(std::vector<std::tuple<N, N, E>> edges) {
+  std::sort(edges.begin(), edges.end(), lessEdgeTuple);
+  bulkLoadSorted(std::move(edges));
+}
+
+// Loads a sorted batch of edges
+// Every edge and adjacency insert is at the end of its set, since the batch is in edge order
+template <typename N, typename E>
+void Graph<N, E>::bulkLoadSorted(std::vector<std::tuple<N, N, E>> edges) {
+  edges.erase(std::unique(edges.begin(), edges.end(),
+                          [](const auto& a, const auto& b) { return !lessEdgeTuple(a, b); }),
+              edges.end());
+
+  Node* source = nullptr;
+  for (auto& edge : edges) {
+    // Consecutive edges mostly share a source, so it is only looked up when it changes
+    if (!source || !(source->value_ == std::get<0>(edge)))
+      source = findOrInsertNode(std::move(std::get<0>(edge)));
+    Node* destination = findOrInsertNode(std::move(std::get<1>(edge)));
+
+    auto edgeItr =
+        edges_.emplace_hint(edges_.end(), source, destination, std::move(std::get<2>(edge)));
+    source->out_.emplace_hint(source->out_.end(), &*edgeItr);
+    destination->in_.emplace_hint(destination->in_.end(), &*edgeItr);
+  }
+}
+
+// Reads an edge list with two chunks, so the next chunk is read and tokenised in the background
+// while the current one is inserted
+// Only the two chunks and one batch of edges are held on top of the graph
+template <typename N, typename E>
+Graph<N, E> Graph<N, E>::readEdgeList(const EdgeListReader& reader,
+                                      std::pmr::memory_resource* resource) {
+  StatsScope scope{GraphMethod::ReadEdgeList};
+  Graph g{resource};
+  std::array<EdgeListChunk, 2> chunks;
+  std::string carry;
+  std::vector<std::tuple<Node*, Node*, E>> batch;
+
+  // The future waits for the background read when it goes out of scope, even on a throw
+  std::size_t current = 0;
+  readEdgeListChunk(reader, chunks[current], carry);
+  for (; !chunks[current].last_; current = 1 - current) {
+    auto next = std::async(std::launch::async, [&reader, &chunks, &carry, current] {
+      readEdgeListChunk(reader, chunks[1 - current], carry);
+    });
+    g.insertEdgeListChunk(chunks[current], batch);
+    next.get();
+  }
+  g.insertEdgeListChunk(chunks[current], batch);
+  return g;
+}
+
+// Reads the next chunk of whole lines and splits each line into its fields
+// The partial line at the end of the chunk is carried over to the next one
+template <typename N, typename E>
+void Graph<N, E>::readEdgeListChunk(const EdgeListReader& reader,
+                                    EdgeListChunk& chunk,
+                                    std::string& carry) {
+  std::string& text = chunk.text_;
+  text.assign(carry);
+  std::size_t carried = text.size();
+  text.resize(carried + edgeListChunkSize_);
+  text.resize(carried + reader(&text[carried], edgeListChunkSize_));
+  chunk.last_ = text.size() == carried;
+
+  if (chunk.last_) {
+    carry.clear();
+  } else {
+    auto lineEnd = text.rfind('\n');
+    lineEnd = lineEnd == std::string::npos ? 0 : lineEnd + 1;
+    carry.assign(text, lineEnd);
+    text.resize(lineEnd);
+  }
+
+  chunk.records_.clear();
+  std::string_view rest{text};
+  while (!rest.empty()) {
+    auto lineLength = std::min(rest.find('\n'), rest.size());
+    std::string_view line = rest.substr(0, lineLength);
+    rest.remove_prefix(std::min(lineLength + 1, rest.size()));
+
+    std::array<std::string_view, 3> fields;
+    std::size_t count = 0;
+    for (auto start = line.find_first_not_of(" \t\r"); start != std::string_view::npos;
+         start = line.find_first_not_of(" \t\r", start)) {
+      auto end = std::min(line.find_first_of(" \t\r", start), line.size());
+      if (count == fields.size())
+        throw std::runtime_error(
+            "Cannot call Graph::ReadEdgeList on a line that is not \"src dst weight\"");
+      fields[count++] = line.substr(start, end - start);
+      start = end;
+    }
+    if (count == 0)
+      continue;
+    if (count != fields.size())
+      throw std::runtime_error(
+          "Cannot call Graph::ReadEdgeList on a line that is not \"src dst weight\"");
+    chunk.records_.push_back(fields);
+  }
+}
+
+// Inserts the edges of a chunk, inserting their nodes as needed
+// The batch is sorted so that edges inserted one after another are next to each other in the set
+template <typename N, typename E>
+void Graph<N, E>::insertEdgeListChunk(const EdgeListChunk& chunk,
+                                      std::vector<std::tuple<Node*, Node*, E>>& batch) {
+  // Values are parsed into reused scratch space and only copied in for new nodes
+  N value{};
+  Node* source = nullptr;
+  batch.clear();
+  for (const auto& fields : chunk.records_) {
+    parseField(fields[0], value);
+    if (!source || !(source->value_ == value))
+      source = findOrInsertNode(value);
+    parseField(fields[1], value);
+    Node* destination = findOrInsertNode(value);
+    E weight{};
+    parseField(fields[2], weight);
+    batch.emplace_back(source, destination, std::move(weight));
+  }
+
+  std::sort(batch.begin(), batch.end(), [](const auto& a, const auto& b) {
+    return sortEdges::less({std::get<0>(a)->value_, std::get<1>(a)->value_, &std::get<2>(a)},
+                           {std::get<0>(b)->value_, std::get<1>(b)->value_, &std::get<2>(b)});
+  });
+  auto hint = edges_.begin();
+  for (auto& [from, to, weight] : batch) {
+    auto size = edges_.size();
+    hint = edges_.emplace_hint(hint, from, to, std::move(weight));
+    if (edges_.size() != size)
+      linkAdjacency(*hint);
+    hint++;
+  }
+}
+
+// Parses a field into a value, without allocating for arithmetic types or strings with capacity
+template <typename N, typename E>
+template <typename T>
+void Graph<N, E>::parseField(std::string_view field, T& value) {
+  bool parsed;
+  if constexpr (std::is_same<T, std::string>::value) {
+    value.assign(field);
+    parsed = true;
+  } else if constexpr (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) {
+    auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+    parsed = result.ec == std::errc{} && result.ptr == field.data() + field.size();
+  } else {
+    std::istringstream stream{std::string{field}};
+    parsed = static_cast<bool>(stream >> value) && (stream >> std::ws).eof();
+  }
+  if (!parsed)
+    throw std::runtime_error("Cannot call Graph::ReadEdgeList on a field that can't be parsed");
+}
+
+// Dijkstra's algorithm using a 4-ary heap with lazy deletion
+// A node can be in the heap more than once, but only its closest entry settles it
+template <typename N, typename E>
+std::unordered_map<const typename Graph<N, E>::Node*, typename Graph<N, E>::Label>
+Graph<N, E>::dijkstra(const Node& source, const Node* target) const {
+  std::unordered_map<const Node*, Label> labels;
+  DaryHeap<std::pair<E, const Node*>, closerFirst> frontier;
+  labels.emplace(&source, Label{E{}, nullptr, false});
+  frontier.push({E{}, &source});
+
+  while (!frontier.empty()) {
+    auto [distance, node] = frontier.pop();
+    auto& label = labels.find(node)->second;
+    if (label.settled_)
+      continue;
+    label.settled_ = true;
+    if (node == target)
+      break;
+
+    // Edges to a destination are sorted by weight, so only the first one can be the shortest
+    countEdgesScanned(target ? GraphMethod::ShortestPath : GraphMethod::ShortestPaths,
+                      node->out_.size());
+    const Node* previous = nullptr;
+    for (const Edge* edge : node->out_) {
+      if (edge->destination_ == previous)
+        continue;
+      previous = edge->destination_;
+      if (edge->weight_ < E{}) {
+        throw std::runtime_error(
+            "Cannot call Graph::ShortestPath or Graph::ShortestPaths with negative weights");
+      }
+
+      E candidate = distance + edge->weight_;
+      auto [labelItr, inserted] =
+          labels.try_emplace(edge->destination_, Label{candidate, node, false});
+      if (!inserted) {
+        if (labelItr->second.settled_ || !(candidate < labelItr->second.distance_))
+          continue;
+        labelItr->second.distance_ = candidate;
+        labelItr->second.parent_ = node;
+      }
+      frontier.push({std::move(candidate), edge->destination_});
+    }
+  }
+  return labels;
+}
+
+// Sorts the positions of a batch rather than the batch itself, so results stay in batch order
+template <typename N, typename E>
+std::vector<std::size_t> Graph<N, E>::sortedOrder(const std::vector<std::tuple<N, N, E>>& edges) {
+  std::vector<std::size_t> order(edges.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&edges](std::size_t a, std::size_t b) {
+    return lessEdgeTuple(edges[a], edges[b]);
+  });
+  return order;
+}
+
+// Compares edges given as tuples in the same order as the edge set
+template <typename N, typename E>
+bool Graph<N, E>::lessEdgeTuple(const std::tuple<N, N, E>& a, const std::tuple<N, N, E>& b) {
+  return sortEdges::less({std::get<0>(a), std::get<1>(a), &std::get<2>(a)},
+                         {std::get<0>(b), std::get<1>(b), &std::get<2>(b)});
+}
+
+// Returns the beginning of a range, as a move iterator if the range is an rvalue
+template <typename N, typename E>
+template <typename Range>
+auto Graph<N, E>::rangeBegin(Range&& range) {
+  if constexpr (std::is_lvalue_reference<Range>::value)
+    return std::begin(range);
+  else
+    return std::make_move_iterator(std::begin(range));
+}
+
+// Returns the end of a range, as a move iterator if the range is an rvalue
+template <typename N, typename E>
+template <typename Range>
+auto Graph<N, E>::rangeEnd(Range&& range) {
+  if constexpr (std::is_lvalue_reference<Range>::value)
+    return std::end(range);
+  else
+    return std::make_move_iterator(std::end(range));
+}
+
+// Returhs true if there is an edge from src to dst with weight w
+template <typename N, typename E>
+bool Graph<N, E>::isEdge(const N& src, const N& dst, const E& w) const noexcept {
+  return edges_.find(EdgeKey{src, dst, &w}) != edges_.end();
+}
+
+// Adds an unlinked edge back into the edge set and the adjacency of its nodes
+// The edge is dropped if an equal edge is already in the graph
+template <typename N, typename E>
+void Graph<N, E>::linkEdge(typename EdgeSet::node_type handle) {
+  auto result = edges_.insert(std::move(handle));
+  if (result.inserted)
+    linkAdjacency(*result.position);
+}
+
+// Adds an edge of the edge set to the adjacency of both of its nodes
+template <typename N, typename E>
+void Graph<N, E>::linkAdjacency(const Edge& edge) {
+  edge.source_->out_.insert(&edge);
+  edge.destination_->in_.insert(&edge);
+}
+
+// Removes an edge from the adjacency of both of its nodes and from the edge set
+// The edge is destroyed unless the caller keeps the returned handle
+template <typename N, typename E>
+typename Graph<N, E>::EdgeSet::node_type Graph<N, E>::unlinkEdge(const Edge& edge) {
+  edge.source_->out_.erase(&edge);
+  edge.destination_->in_.erase(&edge);
+  return edges_.extract(edge);
+}
+
+// Unlinks every edge going into or out of a node and returns them in order
+// Self loops are in both lists of the node but are only returned once
+template <typename N, typename E>
+std::vector<typename Graph<N, E>::EdgeSet::node_type> Graph<N, E>::unlinkIncidentEdges(
+    Node& node) {
+  std::vector<const Edge*> edges{node.out_.begin(), node.out_.end()};
+  for (const Edge* edge : node.in_) {
+    if (edge->source_ != &node)
+      edges.push_back(edge);
+  }
+
+  std::vector<typename EdgeSet::node_type> handles;
+  handles.reserve(edges.size());
+  for (const Edge* edge : edges)
+    handles.push_back(unlinkEdge(*edge));
+  return handles;
+}
+
+// Counts a comparison of two node values
+template <typename N, typename E>
+void Graph<N, E>::countNodeComparison() noexcept {
+  if constexpr (statsEnabled)
+    stats_.nodeComparisons_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Counts a comparison of two edges
+template <typename N, typename E>
+void Graph<N, E>::countEdgeComparison() noexcept {
+  if constexpr (statsEnabled)
+    stats_.edgeComparisons_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Counts the edges a method walked over
+template <typename N, typename E>
+void Graph<N, E>::countEdgesScanned(GraphMethod method, std::size_t edges) noexcept {
+  if constexpr (statsEnabled) {
+    stats_.methods_[static_cast<std::size_t>(method)].edgesScanned_.fetch_add(
+        edges, std::memory_order_relaxed);
+  }
+}
+
+// Counts a call of a method in the latency bucket of its bit length in nanoseconds
+template <typename N, typename E>
+void Graph<N, E>::countCall(GraphMethod method,
+                            std::chrono::steady_clock::duration latency) noexcept {
+  if constexpr (statsEnabled) {
+    auto& counters = stats_.methods_[static_cast<std::size_t>(method)];
+    counters.calls_.fetch_add(1, std::memory_order_relaxed);
+    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+    std::size_t bucket = 0;
+    for (; nanoseconds > 0 && bucket + 1 < GraphStats::latencyBuckets; nanoseconds >>= 1)
+      bucket++;
+    counters.latency_[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+// Wraps a resource so that the allocations made from it are counted
+// Graphs on the same resource share a wrapper, so they can still take over each other's storage
+// Wrappers are never freed, since a graph can outlive the static objects of its translation unit
+template <typename N, typename E>
+std::pmr::memory_resource* Graph<N, E>::statsResource(std::pmr::memory_resource* resource) {
+  if constexpr (!statsEnabled) {
+    return resource;
+  } else {
+    static std::mutex mutex;
+    static auto* wrappers =
+        new std::unordered_map<std::pmr::memory_resource*, std::unique_ptr<StatsResource>>;
+    std::lock_guard<std::mutex> lock{mutex};
+    auto& wrapper = (*wrappers)[resource];
+    if (!wrapper)
+      wrapper = std::make_unique<StatsResource>(resource);
+    return wrapper.get();
+  }
+}
+
+// ----------------------- FrozenGraph ----------------------------
+// Constructor that takes ownership of the arrays of a snapshot
+template <typename N, typename E>
+FrozenGraph<N, E>::FrozenGraph(Arrays arrays) {
+  auto storage = std::make_shared<const Arrays>(std::move(arrays));
+  nodes_ = storage->nodes_.data();
+  nodeCount_ = storage->nodes_.size();
+  offsets_ = storage->offsets_.data();
+  destinations_ = storage->destinations_.data();
+  weights_ = storage->weights_.data();
+  edgeCount_ = storage->weights_.size();
+  storage_ = std::move(storage);
+}
+
+// Loads a snapshot, mapping the file in place when no value needs to be deserialized
+template <typename N, typename E>
+FrozenGraph<N, E> FrozenGraph<N, E>::Load(const std::string& path) {
+  if constexpr (Serializer<N>::raw && Serializer<E>::raw)
+    return mapFile(path);
+  else
+    return readFile(path);
+}
+
+// Check is a particular node is in the snapshot
+template <typename N, typename E>
+bool FrozenGraph<N, E>::IsNode(const N& val) const noexcept {
+  return indexOf(val) != nodeCount_;
+}
+
+// Checks if 2 nodes are connected by an edge
+template <typename N, typename E>
+bool FrozenGraph<N, E>::IsConnected(const N& src, const N& dst) const {
+  auto source = indexOf(src);
+  auto destination = indexOf(dst);
+  if (source == nodeCount_ || destination == nodeCount_) {
+    throw std::runtime_error(
+        "Cannot call FrozenGraph::IsConnected if src or dst node don't exist in the graph");
+  }
+
+  auto first = destinations_ + offsets_[source];
+  auto last = destinations_ + offsets_[source + 1];
+  return std::binary_search(first, last, destination);
+}
+
+// Gets all the nodes connected to a particular node
+template <typename N, typename E>
+std::vector<N> FrozenGraph<N, E>::GetConnected(const N& src) const {
+  auto source = indexOf(src);
+  if (source == nodeCount_) {
+    throw std::out_of_range(
+        "Cannot call FrozenGraph::GetConnected if src doesn't exist in the graph");
+  }
+
+  std::vector<N> results;
+  results.reserve(offsets_[source + 1] - offsets_[source]);
+  for (auto edge = offsets_[source]; edge != offsets_[source + 1]; edge++)
+    results.push_back(nodes_[destinations_[edge]]);
+  return results;
+}
+
+// Gets the hops to every node that can be reached from src
+template <typename N, typename E>
+std::vector<std::pair<N, std::size_t>> FrozenGraph<N, E>::HopDistances(const N& src,
+                                                                       std::size_t threads) const {
+  auto source = indexOf(src);
+  if (source == nodeCount_) {
+    throw std::out_of_range(
+        "Cannot call FrozenGraph::HopDistances if src doesn't exist in the graph");
+  }
+
+  auto hops = breadthFirst(source, unreached_, threads);
+  std::vector<std::pair<N, std::size_t>> results;
+  for (std::size_t row = 0; row < nodeCount_; row++) {
+    if (hops[row] != unreached_)
+      results.emplace_back(nodes_[row], hops[row]);
+  }
+  return results;
+}
+
+// Gets the nodes within k hops of src, stopping the search after k levels
+template <typename N, typename E>
+std::vector<N> FrozenGraph<N, E>::KHop(const N& src, std::size_t k, std::size_t threads) const {
+  auto source = indexOf(src);
+  if (source == nodeCount_)
+    throw std::out_of_range("Cannot call FrozenGraph::KHop if src doesn't exist in the graph");
+
+  auto hops = breadthFirst(source, k, threads);
+  std::vector<N> results;
+  for (std::size_t row = 0; row < nodeCount_; row++) {
+    if (hops[row] != unreached_)
+      results.push_back(nodes_[row]);
+  }
+  return results;
+}
+
+// Multiplies the adjacency matrix by a vector one row at a time
+// Each row only writes its own entry, so rows are split between threads without locking
+template <typename N, typename E>
+template <typename T>
+std::vector<T> FrozenGraph<N, E>::SpMV(const std::vector<T>& x, std::size_t threads) const {
+  if (x.size() != nodeCount_) {
+    throw std::runtime_error(
+        "Cannot call FrozenGraph::SpMV with a vector that doesn't have a value per node");
+  }
+
+  std::vector<T> y(nodeCount_);
+  parallelFor(nodeCount_, threads, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (auto row = begin; row != end; row++) {
+      T sum{};
+      for (auto edge = offsets_[row]; edge != offsets_[row + 1]; edge++)
+        sum += static_cast<T>(weights_[edge]) * x[destinations_[edge]];
+      y[row] = sum;
+    }
+  });
+  return y;
+}
+
+// Gets the rank of every node, with every edge of a node getting an equal share
+template <typename N, typename E>
+std::vector<std::pair<N, double>> FrozenGraph<N, E>::PageRank(double damping,
+                                                              double tolerance,
+                                                              std::size_t maxIterations,
+                                                              std::size_t threads) const {
+  auto ranks = pageRank(false, damping, tolerance, maxIterations, threads);
+  std::vector<std::pair<N, double>> results;
+  results.reserve(nodeCount_);
+  for (std::size_t row = 0; row < nodeCount_; row++)
+    results.emplace_back(nodes_[row], ranks[row]);
+  return results;
+}
+
+// Gets the rank of every node, with the edges of a node getting a share by weight
+template <typename N, typename E>
+std::vector<std::pair<N, double>> FrozenGraph<N, E>::WeightedPageRank(double damping,
+                                                                      double tolerance,
+                                                                      std::size_t maxIterations,
+                                                                      std::size_t threads) const {
+  static_assert(std::is_convertible<E, double>::value,
+                "FrozenGraph::WeightedPageRank needs weights that convert to double");
+  auto ranks = pageRank(true, damping, tolerance, maxIterations, threads);
+  std::vector<std::pair<N, double>> results;
+  results.reserve(nodeCount_);
+  for (std::size_t row = 0; row < nodeCount_; row++)
+    results.emplace_back(nodes_[row], ranks[row]);
+  return results;
+}
+
+// Gets the strongly connected component of every node
+template <typename N, typename E>
+std::vector<std::pair<N, std::size_t>> FrozenGraph<N, E>::StronglyConnectedComponents() const {
+  return components(stronglyConnected());
+}
+
+// Gets the weakly connected component of every node
+template <typename N, typename E>
+std::vector<std::pair<N, std::size_t>> FrozenGraph<N, E>::WeaklyConnectedComponents(
+    std::size_t threads) const {
+  return components(weaklyConnected(threads));
+}
+
+// Get the weights of all edges connecting src and dst
+// A row is sorted by destination and then weight, so the weights form one sorted run
+template <typename N, typename E>
+std::vector<E> FrozenGraph<N, E>::GetWeights(const N& src, const N& dst) const {
+  auto source = indexOf(src);
+  auto destination = indexOf(dst);
+  if (source == nodeCount_ || destination == nodeCount_) {
+    throw std::runtime_error(
+        "Cannot call FrozenGraph::GetWeights if src or dst node don't exist in the graph");
+  }
+
+  auto first = destinations_ + offsets_[source];
+  auto last = destinations_ + offsets_[source + 1];
+  auto range = std::equal_range(first, last, destination);
+  return {weights_ + (range.first - destinations_), weights_ + (range.second - destinations_)};
+}
+
+// Writes the snapshot as a header followed by the offset, destination, node and weight arrays
+// The header is written last, once the position of every array is known
+template <typename N, typename E>
+void FrozenGraph<N, E>::Save(const std::string& path) const {
+  std::ofstream os{path, std::ios::binary | std::ios::trunc};
+  if (!os)
+    throw std::runtime_error("Cannot call FrozenGraph::Save on a file that can't be written");
+
+  FileHeader header{{'G', 'D', 'W', 'G'},
+                    formatVersion_,
+                    sizeof(std::size_t),
+                    Serializer<N>::raw ? static_cast<std::uint32_t>(sizeof(N)) : 0,
+                    Serializer<E>::raw ? static_cast<std::uint32_t>(sizeof(E)) : 0,
+                    nodeCount_,
+                    edgeCount_,
+                    0,
+                    0,
+                    0,
+                    0};
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  header.offsetsAt_ = writeSection(os, offsets_, nodeCount_ + 1);
+  header.destinationsAt_ = writeSection(os, destinations_, edgeCount_);
+  header.nodesAt_ = writeSection(os, nodes_, nodeCount_);
+  header.weightsAt_ = writeSection(os, weights_, edgeCount_);
+  os.seekp(0);
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  if (!os)
+    throw std::runtime_error("Cannot call FrozenGraph::Save on a file that can't be written");
+}
+
+// Maps a saved snapshot into memory and views its arrays in place
+// Nothing is parsed or copied, pages are only read in as they are used
+template <typename N, typename E>
+FrozenGraph<N, E> FrozenGraph<N, E>::mapFile(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1)
+    throw std::runtime_error("Cannot call FrozenGraph::Load on a file that can't be read");
+
+  struct stat info;
+  if (::fstat(fd, &info) == -1 || static_cast<std::size_t>(info.st_size) < sizeof(FileHeader)) {
+    ::close(fd);
+    throw std::runtime_error(
+        "Cannot call FrozenGraph::Load on a file that was not written by Save");
+  }
+
+  std::size_t size = info.st_size;
+  void* memory = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED)
+    throw std::runtime_error("Cannot call FrozenGraph::Load on a file that can't be read");
+  std::shared_ptr<const void> storage{memory,
+                                      [size](const void* base) {
+                                        ::munmap(const_cast<void*>(base), size);
+                                      }};
+
+  FileHeader header;
+  std::memcpy(&header, memory, sizeof(header));
+  checkHeader(header, size);
+
+  const char* base = static_cast<const char*>(memory);
+  auto offsets = reinterpret_cast<const std::size_t*>(base + header.offsetsAt_);
+  if (offsets[header.nodeCount_] != header.edgeCount_)
+    throw std::runtime_error(
+        "Cannot call FrozenGraph::Load on a file that was not written by Save");
+  return {reinterpret_cast<const N*>(base + header.nodesAt_),
+          header.nodeCount_,
+          offsets,
+          reinterpret_cast<const std::size_t*>(base + header.destinationsAt_),
+          reinterpret_cast<const E*>(base + header.weightsAt_),
+          header.edgeCount_,
+          std::move(storage)};
+}
+
+// Reads a saved snapshot into owned arrays, deserializing values that aren't raw bytes
+template <typename N, typename E>
+FrozenGraph<N, E> FrozenGraph<N, E>::readFile(const std::string& path) {
+  std::ifstream is{path, std::ios::binary | std::ios::ate};
+  if (!is)
+    throw std::runtime_error("Cannot call FrozenGraph::Load on a file that can't be read");
+
+  std::uint64_t size = is.tellg();
+  FileHeader header;
+  is.seekg(0);
+  if (size < sizeof(header) || !is.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    throw std::runtime_error(
+        "Cannot call FrozenGraph::Load on a file that was not written by Save");
+  checkHeader(header, size);
+
+  Arrays arrays{readSection<N>(is, header.nodesAt_, header.nodeCount_),
+                readSection<std::size_t>(is, header.offsetsAt_, header.nodeCount_ + 1),
+                readSection<std::size_t>(is, header.destinationsAt_, header.edgeCount_),
+                readSection<E>(is, header.weightsAt_, header.edgeCount_)};
+  if (!is || arrays.offsets_.back() != header.edgeCount_)
+    throw std::runtime_error(
+        "Cannot call FrozenGraph::Load on a file that was not written by Save");
+  return FrozenGraph{std::move(arrays)};
+}
+
+// Checks that a header belongs to a snapshot of this type and that its arrays fit in the file
+template <typename N, typename E>
+void FrozenGraph<N, E>::checkHeader(const FileHeader& header, std::uint64_t fileSize) {
+  auto fits = [fileSize](std::uint64_t at, std::uint64_t count, std::size_t size,
+                         std::size_t align) -> bool {
+    return at % align == 0 && at <= fileSize && count <= (fileSize - at) / size;
+  };
+  bool valid = std::equal(header.magic_, header.magic_ + 4, "GDWG") &&
+               header.version_ == formatVersion_ && header.indexSize_ == sizeof(std::size_t) &&
+               header.nodeSize_ == (Serializer<N>::raw ? sizeof(N) : 0) &&
+               header.weightSize_ == (Serializer<E>::raw ? sizeof(E) : 0) &&
+               fits(header.offsetsAt_, header.nodeCount_ + 1, sizeof(std::size_t),
+                    alignof(std::size_t)) &&
+               fits(header.destinationsAt_, header.edgeCount_, sizeof(std::size_t),
+                    alignof(std::size_t)) &&
+               fits(header.nodesAt_, Serializer<N>::raw ? header.nodeCount_ : 0, sizeof(N),
+                    alignof(N)) &&
+               fits(header.weightsAt_, Serializer<E>::raw ? header.edgeCount_ : 0, sizeof(E),
+                    alignof(E));
+  if (!valid)
+    throw std::runtime_error(
+        "Cannot call FrozenGraph::Load on a file that was not written by Save");
+}
+
+// Writes one array, aligned so that it can be used in place once the file is mapped
+// Returns the position of the array in the file
+template <typename N, typename E>
+template <typename T>
+std::uint64_t FrozenGraph<N, E>::writeSection(std::ostream& os,
+                                              const T* values,
+                                              std::size_t count) {
+  std::uint64_t at = os.tellp();
+  while (at % alignof(std::max_align_t) != 0) {
+    os.put('\0');
+    at++;
+  }
+
+  if constexpr (Serializer<T>::raw) {
+    os.write(reinterpret_cast<const char*>(values), count * sizeof(T));
+  } else {
+    for (std::size_t i = 0; i < count; i++)
+      Serializer<T>::write(os, values[i]);
+  }
+  return at;
+}
+
+// Reads one array from the given position in the file
+template <typename N, typename E>
+template <typename T>
+std::vector<T> FrozenGraph<N, E>::readSection(std::istream& is,
+                                              std::uint64_t at,
+                                              std::size_t count) {
+  std::vector<T> values;
+  is.seekg(at);
+  if constexpr (Serializer<T>::raw) {
+    values.resize(count);
+    is.read(reinterpret_cast<char*>(values.data()), count * sizeof(T));
+  } else {
+    for (std::size_t i = 0; i < count && is; i++)
+      values.push_back(Serializer<T>::read(is));
+  }
+  return values;
+}
+
+// Finds the position of a node with a binary search over the sorted nodes
+template <typename N, typename E>
+std::size_t FrozenGraph<N, E>::indexOf(const N& val) const noexcept {
+  auto nodeItr = std::lower_bound(nodes_, nodes_ + nodeCount_, val);
+  if (nodeItr == nodes_ + nodeCount_ || !(*nodeItr == val))
+    return nodeCount_;
+  return nodeItr - nodes_;
+}
+
+// Builds the incoming edges by counting the edges into each row and then placing them
+template <typename N, typename E>
+const typename FrozenGraph<N, E>::Transpose& FrozenGraph<N, E>::transpose() const {
+  std::call_once(transpose_->built_, [this] {
+    auto& offsets = transpose_->offsets_;
+    auto& sources = transpose_->sources_;
+    offsets.assign(nodeCount_ + 1, 0);
+    for (std::size_t edge = 0; edge < edgeCount_; edge++)
+      offsets[destinations_[edge] + 1]++;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<std::size_t> next{offsets.begin(), offsets.end() - 1};
+    auto& edges = transpose_->edges_;
+    sources.resize(edgeCount_);
+    edges.resize(edgeCount_);
+    for (std::size_t row = 0; row < nodeCount_; row++) {
+      for (auto edge = offsets_[row]; edge != offsets_[row + 1]; edge++) {
+        auto position = next[destinations_[edge]]++;
+        sources[position] = row;
+        edges[position] = edge;
+      }
+    }
+  });
+  return *transpose_;
+}
+
+// PageRank by power iteration, pulling rank along the incoming edges of every row
+// Each iteration is two flat passes: one scaling every rank by the share each of its edges gets,
+// then one summing the shares over the incoming edges. Rows with no outgoing weight spread
+// their rank evenly over every row.
+template <typename N, typename E>
+std::vector<double> FrozenGraph<N, E>::pageRank(bool weighted,
+                                                double damping,
+                                                double tolerance,
+                                                std::size_t maxIterations,
+                                                std::size_t threads) const {
+  auto n = nodeCount_;
+  if (n == 0)
+    return {};
+  threads = std::max<std::size_t>(1, threads);
+  const auto& incoming = transpose();
+
+  // The weight of each incoming edge and the share of a row's rank each unit of weight gets
+  std::vector<double> inWeights(edgeCount_, 1.0);
+  std::vector<double> shares(n);
+  if constexpr (std::is_convertible<E, double>::value) {
+    if (weighted) {
+      for (std::size_t edge = 0; edge < edgeCount_; edge++)
+        inWeights[edge] = static_cast<double>(weights_[incoming.edges_[edge]]);
+    }
+  }
+  for (std::size_t row = 0; row < n; row++) {
+    double total = offsets_[row + 1] - offsets_[row];
+    if constexpr (std::is_convertible<E, double>::value) {
+      if (weighted) {
+        total = 0;
+        for (auto edge = offsets_[row]; edge != offsets_[row + 1]; edge++)
+          total += static_cast<double>(weights_[edge]);
+      }
+    }
+    shares[row] = total > 0 ? 1 / total : 0;
+  }
+
+  std::vector<double> ranks(n, 1.0 / n);
+  std::vector<double> next(n);
+  std::vector<double> contributions(n);
+  std::vector<double> partials(threads);
+  for (std::size_t iteration = 0; iteration < maxIterations; iteration++) {
+    std::fill(partials.begin(), partials.end(), 0.0);
+    parallelFor(n, threads, [&](std::size_t begin, std::size_t end, std::size_t t) {
+      double dangling = 0;
+      for (auto row = begin; row != end; row++) {
+        contributions[row] = ranks[row] * shares[row];
+        dangling += shares[row] == 0 ? ranks[row] : 0;
+      }
+      partials[t] = dangling;
+    });
+    auto base = (1 - damping) / n +
+                damping * std::accumulate(partials.begin(), partials.end(), 0.0) / n;
+
+    std::fill(partials.begin(), partials.end(), 0.0);
+    parallelFor(n, threads, [&](std::size_t begin, std::size_t end, std::size_t t) {
+      double change = 0;
+      for (auto row = begin; row != end; row++) {
+        double sum = 0;
+        for (auto edge = incoming.offsets_[row]; edge != incoming.offsets_[row + 1]; edge++)
+          sum += contributions[incoming.sources_[edge]] * inWeights[edge];
+        next[row] = base + damping * sum;
+        change += std::abs(next[row] - ranks[row]);
+      }
+      partials[t] = change;
+    });
+    ranks.swap(next);
+    if (std::accumulate(partials.begin(), partials.end(), 0.0) < tolerance)
+      break;
+  }
+  return ranks;
+}
+
+// Tarjan's algorithm in O(V + E), with the recursion kept on the heap
+// Each call frame is a row and the next of its edges to follow
+template <typename N, typename E>
+std::vector<std::size_t> FrozenGraph<N, E>::stronglyConnected() const {
+  std::vector<std::size_t> order(nodeCount_, unreached_);
+  std::vector<std::size_t> low(nodeCount_);
+  std::vector<std::size_t> component(nodeCount_, unreached_);
+  std::vector<std::size_t> open;
+  std::vector<std::pair<std::size_t, std::size_t>> calls;
+  std::size_t visited = 0;
+
+  auto visit = [&](std::size_t row) {
+    order[row] = low[row] = visited++;
+    open.push_back(row);
+    calls.emplace_back(row, offsets_[row]);
+  };
+
+  for (std::size_t root = 0; root < nodeCount_; root++) {
+    if (order[root] != unreached_)
+      continue;
+    visit(root);
+    while (!calls.empty()) {
+      auto [row, edge] = calls.back();
+      if (edge != offsets_[row + 1]) {
+        calls.back().second++;
+        auto next = destinations_[edge];
+        if (order[next] == unreached_)
+          visit(next);
+        else if (component[next] == unreached_)
+          low[row] = std::min(low[row], order[next]);
+        continue;
+      }
+
+      // Every edge of the row is done, so it either closes a component or passes its low up
+      if (low[row] == order[row]) {
+        std::size_t member;
+        do {
+          member = open.back();
+          open.pop_back();
+          component[member] = row;
+        } while (member != row);
+      }
+      calls.pop_back();
+      if (!calls.empty())
+        low[calls.back().first] = std::min(low[calls.back().first], low[row]);
+    }
+  }
+  return component;
+}
+
+// Union find over the edges, with each thread taking a block of rows
+// Roots are only ever linked to a smaller root, so every row's parent is at most the row and
+// concurrent links and path halving can't form a cycle
+template <typename N, typename E>
+std::vector<std::size_t> FrozenGraph<N, E>::weaklyConnected(std::size_t threads) const {
+  std::vector<std::atomic<std::size_t>> parents(nodeCount_);
+  parallelFor(nodeCount_, threads, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (auto row = begin; row != end; row++)
+      parents[row].store(row, std::memory_order_relaxed);
+  });
+
+  auto find = [&parents](std::size_t row) {
+    for (;;) {
+      auto parent = parents[row].load(std::memory_order_relaxed);
+      if (parent == row)
+        return row;
+      auto grandparent = parents[parent].load(std::memory_order_relaxed);
+      parents[row].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+      row = grandparent;
+    }
+  };
+
+  parallelFor(nodeCount_, threads, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (auto row = begin; row != end; row++) {
+      for (auto edge = offsets_[row]; edge != offsets_[row + 1]; edge++) {
+        auto a = row;
+        auto b = destinations_[edge];
+        for (;;) {
+          a = find(a);
+          b = find(b);
+          if (a == b)
+            break;
+          if (a < b)
+            std::swap(a, b);
+          auto root = a;
+          if (parents[a].compare_exchange_strong(root, b, std::memory_order_relaxed))
+            break;
+        }
+      }
+    }
+  });
+
+  std::vector<std::size_t> component(nodeCount_);
+  parallelFor(nodeCount_, threads, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (auto row = begin; row != end; row++)
+      component[row] = find(row);
+  });
+  return component;
+}
+
+// Numbers the components in the order their first row appears and pairs each node with its own
+template <typename N, typename E>
+std::vector<std::pair<N, std::size_t>> FrozenGraph<N, E>::components(
+    const std::vector<std::size_t>& labels) const {
+  std::vector<std::size_t> numbers(nodeCount_, unreached_);
+  std::size_t count = 0;
+  std::vector<std::pair<N, std::size_t>> results;
+  results.reserve(nodeCount_);
+  for (std::size_t row = 0; row < nodeCount_; row++) {
+    auto& number = numbers[labels[row]];
+    if (number == unreached_)
+      number = count++;
+    results.emplace_back(nodes_[row], number);
+  }
+  return results;
+}
+
+// Direction optimizing breadth first search
+// Levels go top down, with the frontier claiming its unvisited destinations, until the frontier
+// has more edges than a fraction of the unexplored ones. Levels then go bottom up, with every
+// unvisited row looking for a source in the frontier, until the frontier is small again.
+template <typename N, typename E>
+std::vector<std::size_t> FrozenGraph<N, E>::breadthFirst(std::size_t source,
+                                                         std::size_t maxHops,
+                                                         std::size_t threads) const {
+  constexpr std::size_t topDownFraction = 14;
+  constexpr std::size_t bottomUpFraction = 24;
+  threads = std::max<std::size_t>(1, threads);
+  auto degree = [this](std::size_t row) { return offsets_[row + 1] - offsets_[row]; };
+
+  std::vector<std::size_t> hops(nodeCount_, unreached_);
+  AtomicBitset visited{nodeCount_};
+  AtomicBitset inFrontier{nodeCount_};
+  std::vector<std::size_t> frontier{source};
+  std::vector<std::vector<std::size_t>> next(threads);
+  hops[source] = 0;
+  visited.set(source);
+  std::size_t frontierEdges = degree(source);
+  std::size_t unexploredEdges = edgeCount_ - frontierEdges;
+  bool bottomUp = false;
+
+  for (std::size_t hop = 1; !frontier.empty() && hop <= maxHops; hop++) {
+    if (!bottomUp)
+      bottomUp = frontierEdges > unexploredEdges / topDownFraction;
+    else
+      bottomUp = frontier.size() >= nodeCount_ / bottomUpFraction;
+
+    if (bottomUp) {
+      const auto& incoming = transpose();
+      inFrontier.clear();
+      for (auto row : frontier)
+        inFrontier.set(row);
+      parallelFor(nodeCount_, threads, [&](std::size_t begin, std::size_t end, std::size_t t) {
+        for (auto row = begin; row != end; row++) {
+          if (visited.test(row))
+            continue;
+          for (auto edge = incoming.offsets_[row]; edge != incoming.offsets_[row + 1]; edge++) {
+            if (inFrontier.test(incoming.sources_[edge])) {
+              visited.set(row);
+              hops[row] = hop;
+              next[t].push_back(row);
+              break;
+            }
+          }
+        }
+      });
+    } else {
+      parallelFor(frontier.size(), threads, [&](std::size_t begin, std::size_t end, std::size_t t) {
+        for (auto i = begin; i != end; i++) {
+          for (auto edge = offsets_[frontier[i]]; edge != offsets_[frontier[i] + 1]; edge++) {
+            auto row = destinations_[edge];
+            if (!visited.test(row) && visited.set(row)) {
+              hops[row] = hop;
+              next[t].push_back(row);
+            }
+          }
+        }
+      });
+    }
+
+    frontier.clear();
+    frontierEdges = 0;
+    for (auto& rows : next) {
+      for (auto row : rows)
+        frontierEdges += degree(row);
+      frontier.insert(frontier.end(), rows.begin(), rows.end());
+      rows.clear();
+    }
+    unexploredEdges -= std::min(unexploredEdges, frontierEdges);
+  }
+  return hops;
+}
+
+// Finds the first row that has an edge, which is where iteration starts
+template <typename N, typename E>
+std::size_t FrozenGraph<N, E>::firstRow() const noexcept {
+  std::size_t row = 0;
+  while (row < nodeCount_ && offsets_[row + 1] == 0)
+    ++row;
+  return row;
+}
+
+// ----------------------- GraphBuilder ----------------------------
+
+// Creates the shards, with at least one
+template <typename N, typename E>
+GraphBuilder<N, E>::GraphBuilder(std::size_t shards)
+  : shardCount_{isHashable<N>::value ? std::max<std::size_t>(1, shards) : 1},
+    shards_{new Shard[shardCount_]} {}
+
+// Adds a node to its shard
+template <typename N, typename E>
+void GraphBuilder<N, E>::InsertNode(N val) {
+  auto& shard = shardOf(val);
+  std::lock_guard<std::mutex> lock{shard.mutex_};
+  shard.nodes_.push_back(std::move(val));
+}
+
+// Adds an edge to the shard of its source
+template <typename N, typename E>
+void GraphBuilder<N, E>::InsertEdge(N src, N dst, E w) {
+  auto& shard = shardOf(src);
+  std::lock_guard<std::mutex> lock{shard.mutex_};
+  shard.edges_.emplace_back(std::move(src), std::move(dst), std::move(w));
+}
+
+// Sorts every shard on its own thread, merges the sorted shards pairwise and bulk loads them
+template <typename N, typename E>
+Graph<N, E> GraphBuilder<N, E>::Finalize(std::pmr::memory_resource* resource) {
+  using Tuple = std::tuple<N, N, E>;
+  std::vector<std::thread> sorters;
+  for (std::size_t shard = 1; shard < shardCount_; shard++) {
+    sorters.emplace_back([this, shard] {
+      auto& edges = shards_[shard].edges_;
+      std::sort(edges.begin(), edges.end(), Graph<N, E>::lessEdgeTuple);
+    });
+  }
+  std::sort(shards_[0].edges_.begin(), shards_[0].edges_.end(), Graph<N, E>::lessEdgeTuple);
+  for (auto& sorter : sorters)
+    sorter.join();
+
+  // Each run is a sorted shard, and neighbouring runs are merged until there is one
+  std::size_t total = 0;
+  for (std::size_t shard = 0; shard < shardCount_; shard++)
+    total += shards_[shard].edges_.size();
+  std::vector<Tuple> edges;
+  edges.reserve(total);
+  std::vector<std::size_t> runs{0};
+  for (std::size_t shard = 0; shard < shardCount_; shard++) {
+    auto& shardEdges = shards_[shard].edges_;
+    edges.insert(edges.end(), std::make_move_iterator(shardEdges.begin()),
+                 std::make_move_iterator(shardEdges.end()));
+    std::vector<Tuple>{}.swap(shardEdges);
+    runs.push_back(edges.size());
+  }
+  while (runs.size() > 2) {
+    std::vector<std::size_t> merged{0};
+    for (std::size_t run = 2; run < runs.size(); run += 2) {
+      std::inplace_merge(edges.begin() + runs[run - 2], edges.begin() + runs[run - 1],
+                         edges.begin() + runs[run], Graph<N, E>::lessEdgeTuple);
+      merged.push_back(runs[run]);
+    }
+    if (runs.size() % 2 == 0)
+      merged.push_back(runs.back());
+    runs.swap(merged);
+  }
+
+  Graph<N, E> g{resource};
+  g.bulkLoadSorted(std::move(edges));
+  for (std::size_t shard = 0; shard < shardCount_; shard++) {
+    for (auto& node : shards_[shard].nodes_)
+      g.findOrInsertNode(std::move(node));
+    std::vector<N>{}.swap(shards_[shard].nodes_);
+  }
+  return g;
+}
+
+// Picks a shard by hash, or the only shard when the node type can't be hashed
+template <typename N, typename E>
+typename GraphBuilder<N, E>::Shard& GraphBuilder<N, E>::shardOf(const N& val) {
+  if constexpr (isHashable<N>::value)
+    return shards_[std::hash<N>{}(val) % shardCount_];
+  else
+    return shards_[0];
+}
+
+// ----------------------- CopyOnWriteGraph ----------------------------
+
+// Takes ownership of a graph
+template <typename N, typename E>
+CopyOnWriteGraph<N, E>::CopyOnWriteGraph(Graph<N, E> g)
+  : graph_{std::make_shared<Graph<N, E>>(std::move(g))} {}
+
+// Clones the graph first if another copy shares it, so that only this copy sees the change
+template <typename N, typename E>
+Graph<N, E>& CopyOnWriteGraph<N, E>::Mutable() {
+  if (graph_.use_count() > 1)
+    graph_ = std::make_shared<Graph<N, E>>(*graph_);
+  return *graph_;
+}
+
+// ----------------------- SharedGraph ----------------------------
+
+// Publishes the initial graph
+template <typename N, typename E>
+SharedGraph<N, E>::SharedGraph(Graph<N, E> g)
+  : snapshot_{std::make_shared<const Graph<N, E>>(std::move(g))}, version_{0} {}
+
+// Loads the published version, which is swapped atomically by writers
+template <typename N, typename E>
+std::shared_ptr<const Graph<N, E>> SharedGraph<N, E>::Snapshot() const {
+  return std::atomic_load(&snapshot_);
+}
+
+// Copies the latest version, changes the copy and publishes it
+// The version is bumped after the copy is published, so a reader that sees the new version
+// always loads at least that graph
+template <typename N, typename E>
+template <typename F>
+void SharedGraph<N, E>::Write(F&& f) {
+  std::lock_guard<std::mutex> lock{writer_};
+  auto next = std::make_shared<Graph<N, E>>(*Snapshot());
+  std::forward<F>(f)(*next);
+  std::atomic_store(&snapshot_, std::shared_ptr<const Graph<N, E>>{std::move(next)});
+  version_.fetch_add(1, std::memory_order_release);
+}
+
+// Only goes to the shared pointer when a newer version has been published
+template <typename N, typename E>
+const Graph<N, E>& SharedGraph<N, E>::Reader::Get() {
+  auto version = shared_->version_.load(std::memory_order_acquire);
+  if (!snapshot_ || version != version_) {
+    snapshot_ = shared_->Snapshot();
+    version_ = version;
+  }
+  return *snapshot_;
+}
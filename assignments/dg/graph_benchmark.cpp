@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "assignments/dg/graph.h"
+
+// Run with: bazel run --config=bench //assignments/dg:graph_benchmark
+// Every benchmark takes {edges, distribution} and is instantiated for <int, int> and
+// <std::string, double>. Besides time per op each reports allocs/op (all heap allocations made
+// in the timed loop) and bytes/edge (bytes the freshly built graph holds from its memory resource).
+
+namespace {
+
+// Heap allocations made by the whole process, counted by the operator new overloads below
+std::atomic<std::int64_t> allocations{0};
+
+}  // namespace
+
+// Kept out of line so the compiler never pairs the inlined malloc with a delete expression
+[[gnu::noinline]] void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+// Memory resource that tracks the bytes currently handed out to a graph
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  std::int64_t Bytes() const { return bytes_; }
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    bytes_ += static_cast<std::int64_t>(bytes);
+    return upstream_->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    bytes_ -= static_cast<std::int64_t>(bytes);
+    upstream_->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource* upstream_ = std::pmr::new_delete_resource();
+  std::int64_t bytes_ = 0;
+};
+
+enum Distribution : std::int64_t { kUniform, kPowerLaw };
+
+// Average out degree of the generated graphs
+constexpr std::int64_t kDegree = 8;
+
+// Node and weight values for the benchmarked types
+template <typename T>
+T MakeValue(std::int64_t i);
+
+template <>
+int MakeValue<int>(std::int64_t i) {
+  return static_cast<int>(i);
+}
+
+template <>
+double MakeValue<double>(std::int64_t i) {
+  return static_cast<double>(i) * 0.5;
+}
+
+// Long enough to defeat the small string optimisation
+template <>
+std::string MakeValue<std::string>(std::int64_t i) {
+  auto digits = std::to_string(i);
+  return "service/node-" + std::string(12 - std::min<std::size_t>(digits.size(), 12), '0') + digits;
+}
+
+// Picks node indices either uniformly or skewed towards low indices, which gives a few hubs
+// with very high degree and a long tail of nodes with almost none
+class NodePicker {
+ public:
+  NodePicker(std::int64_t nodes, Distribution distribution, std::uint64_t seed)
+    : nodes_{nodes}, distribution_{distribution}, rng_{seed} {}
+
+  std::int64_t operator()() {
+    if (distribution_ == kUniform) {
+      return std::uniform_int_distribution<std::int64_t>{0, nodes_ - 1}(rng_);
+    }
+    const auto u = std::uniform_real_distribution<double>{0.0, 1.0}(rng_);
+    const auto i = static_cast<std::int64_t>(static_cast<double>(nodes_) * std::pow(u, 3.0));
+    return std::min(i, nodes_ - 1);
+  }
+
+ private:
+  std::int64_t nodes_;
+  Distribution distribution_;
+  std::mt19937_64 rng_;
+};
+
+template <typename N, typename E>
+struct Workload {
+  std::vector<N> nodes;
+  std::vector<std::tuple<N, N, E>> edges;
+};
+
+// Generates a graph with the given number of edges and an average out degree of kDegree
+template <typename N, typename E>
+Workload<N, E> MakeWorkload(std::int64_t edges, Distribution distribution) {
+  const auto count = std::max<std::int64_t>(edges / kDegree, 2);
+  Workload<N, E> workload;
+  workload.nodes.reserve(static_cast<std::size_t>(count));
+  for (std::int64_t i = 0; i < count; ++i) {
+    workload.nodes.push_back(MakeValue<N>(i));
+  }
+  NodePicker src{count, distribution, 1};
+  NodePicker dst{count, distribution, 2};
+  workload.edges.reserve(static_cast<std::size_t>(edges));
+  for (std::int64_t i = 0; i < edges; ++i) {
+    workload.edges.emplace_back(workload.nodes[static_cast<std::size_t>(src())],
+                                workload.nodes[static_cast<std::size_t>(dst())],
+                                MakeValue<E>(i));
+  }
+  return workload;
+}
+
+// Graph built from a workload on a counting resource
+template <typename N, typename E>
+struct Fixture {
+  Fixture(std::int64_t edges, Distribution distribution)
+    : workload{MakeWorkload<N, E>(edges, distribution)}, graph{&resource} {
+    for (const auto& node : workload.nodes) {
+      graph.InsertNode(node);
+    }
+    for (const auto& [src, dst, weight] : workload.edges) {
+      graph.InsertEdge(src, dst, weight);
+    }
+    const auto count = static_cast<double>(workload.edges.size());
+    bytesPerEdge = static_cast<double>(resource.Bytes()) / count;
+  }
+
+  CountingResource resource;
+  Workload<N, E> workload;
+  gdwg::Graph<N, E> graph;
+  // Measured before the benchmark changes the graph
+  double bytesPerEdge;
+};
+
+// Counts the allocations of a timed loop, leaving out those made while the timer is paused
+class AllocationCounter {
+ public:
+  void Pause(benchmark::State& state) {
+    state.PauseTiming();
+    paused_ = allocations.load();
+  }
+
+  void Resume(benchmark::State& state) {
+    excluded_ += allocations.load() - paused_;
+    state.ResumeTiming();
+  }
+
+  std::int64_t Count() const { return allocations.load() - start_ - excluded_; }
+
+ private:
+  std::int64_t start_ = allocations.load();
+  std::int64_t paused_ = 0;
+  std::int64_t excluded_ = 0;
+};
+
+// Reports the counters shared by every benchmark
+template <typename N, typename E>
+void Report(benchmark::State& state,
+            const Fixture<N, E>& fixture,
+            const AllocationCounter& counter) {
+  state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(counter.Count()),
+                                                   benchmark::Counter::kAvgIterations);
+  state.counters["bytes/edge"] = fixture.bytesPerEdge;
+}
+
+Distribution DistributionOf(const benchmark::State& state) {
+  return static_cast<Distribution>(state.range(1));
+}
+
+// Number of nodes kept ready for the benchmarks that consume nodes
+constexpr std::int64_t kPool = 1024;
+
+// Adds kPool nodes outside the workload, each connected in both directions to kDegree nodes
+template <typename N, typename E>
+std::vector<N> AddSatellites(Fixture<N, E>& fixture, std::int64_t round) {
+  auto& nodes = fixture.workload.nodes;
+  const auto base = static_cast<std::int64_t>(nodes.size()) + round * kPool;
+  NodePicker pick{static_cast<std::int64_t>(nodes.size()), kUniform,
+                  static_cast<std::uint64_t>(round + 3)};
+  std::vector<N> satellites;
+  satellites.reserve(kPool);
+  for (std::int64_t i = 0; i < kPool; ++i) {
+    satellites.push_back(MakeValue<N>(base + i));
+    fixture.graph.InsertNode(satellites.back());
+    for (std::int64_t j = 0; j < kDegree / 2; ++j) {
+      fixture.graph.InsertEdge(satellites.back(), nodes[static_cast<std::size_t>(pick())],
+                               MakeValue<E>(j));
+      fixture.graph.InsertEdge(nodes[static_cast<std::size_t>(pick())], satellites.back(),
+                               MakeValue<E>(j));
+    }
+  }
+  return satellites;
+}
+
+template <typename N, typename E>
+void BM_InsertEdge(benchmark::State& state) {
+  Fixture<N, E> fixture{state.range(0), DistributionOf(state)};
+  const auto& nodes = fixture.workload.nodes;
+  NodePicker src{static_cast<std::int64_t>(nodes.size()), DistributionOf(state), 5};
+  NodePicker dst{static_cast<std::int64_t>(nodes.size()), DistributionOf(state), 6};
+  // Negative weights never collide with the edges already in the graph
+  std::vector<std::tuple<N, N, E>> edges;
+  for (std::int64_t i = 0; i < kPool * kDegree; ++i) {
+    edges.emplace_back(nodes[static_cast<std::size_t>(src())],
+                       nodes[static_cast<std::size_t>(dst())], MakeValue<E>(-1 - i));
+  }
+  std::size_t i = 0;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    const auto& [src, dst, weight] = edges[i];
+    benchmark::DoNotOptimize(fixture.graph.InsertEdge(src, dst, weight));
+    if (++i == edges.size()) {
+      counter.Pause(state);
+      for (const auto& [s, d, w] : edges) {
+        fixture.graph.erase(s, d, w);
+      }
+      i = 0;
+      counter.Resume(state);
+    }
+  }
+  Report(state, fixture, counter);
+}
+
+template <typename N, typename E>
+void BM_DeleteNode(benchmark::State& state) {
+  Fixture<N, E> fixture{state.range(0), DistributionOf(state)};
+  std::int64_t round = 0;
+  auto satellites = AddSatellites(fixture, round);
+  std::size_t i = 0;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fixture.graph.DeleteNode(satellites[i]));
+    if (++i == satellites.size()) {
+      counter.Pause(state);
+      satellites = AddSatellites(fixture, ++round);
+      i = 0;
+      counter.Resume(state);
+    }
+  }
+  Report(state, fixture, counter);
+}
+
+template <typename N, typename E>
+void BM_MergeReplace(benchmark::State& state) {
+  Fixture<N, E> fixture{state.range(0), DistributionOf(state)};
+  std::int64_t round = 0;
+  auto satellites = AddSatellites(fixture, round);
+  std::size_t i = 0;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    fixture.graph.MergeReplace(satellites[i], satellites[i + 1]);
+    i += 2;
+    if (i == satellites.size()) {
+      counter.Pause(state);
+      for (std::size_t j = 1; j < satellites.size(); j += 2) {
+        fixture.graph.DeleteNode(satellites[j]);
+      }
+      satellites = AddSatellites(fixture, ++round);
+      i = 0;
+      counter.Resume(state);
+    }
+  }
+  Report(state, fixture, counter);
+}
+
+template <typename N, typename E>
+void BM_GetConnected(benchmark::State& state) {
+  Fixture<N, E> fixture{state.range(0), DistributionOf(state)};
+  const auto& nodes = fixture.workload.nodes;
+  std::size_t i = 0;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fixture.graph.GetConnected(nodes[i]));
+    i = (i + 7919) % nodes.size();
+  }
+  Report(state, fixture, counter);
+}
+
+template <typename N, typename E>
+void BM_Iterate(benchmark::State& state) {
+  Fixture<N, E> fixture{state.range(0), DistributionOf(state)};
+  AllocationCounter counter;
+  for (auto _ : state) {
+    for (const auto& edge : fixture.graph) {
+      benchmark::DoNotOptimize(edge);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  Report(state, fixture, counter);
+}
+
+template <typename N, typename E>
+void BM_Copy(benchmark::State& state) {
+  Fixture<N, E> fixture{state.range(0), DistributionOf(state)};
+  AllocationCounter counter;
+  for (auto _ : state) {
+    gdwg::Graph<N, E> copy{fixture.graph};
+    benchmark::DoNotOptimize(copy);
+  }
+  Report(state, fixture, counter);
+}
+
+template <typename N, typename E>
+void BM_Equal(benchmark::State& state) {
+  Fixture<N, E> fixture{state.range(0), DistributionOf(state)};
+  const gdwg::Graph<N, E> copy{fixture.graph};
+  AllocationCounter counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fixture.graph == copy);
+  }
+  Report(state, fixture, counter);
+}
+
+template <typename N, typename E>
+void BM_Print(benchmark::State& state) {
+  Fixture<N, E> fixture{state.range(0), DistributionOf(state)};
+  std::ostringstream os;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    os.str("");
+    os << fixture.graph;
+    benchmark::DoNotOptimize(os);
+  }
+  Report(state, fixture, counter);
+}
+
+// 1e3 to 1e7 edges under both degree distributions
+void Sizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"edges", "powerlaw"});
+  b->ArgsProduct({benchmark::CreateRange(1000, 10000000, 10), {kUniform, kPowerLaw}});
+  b->Unit(benchmark::kMicrosecond);
+}
+
+}  // namespace
+
+#define GDWG_BENCHMARK(f)                                                                          \
+  BENCHMARK_TEMPLATE(f, int, int)->Apply(Sizes);                                                   \
+  BENCHMARK_TEMPLATE(f, std::string, double)->Apply(Sizes)
+
+GDWG_BENCHMARK(BM_InsertEdge);
+GDWG_BENCHMARK(BM_DeleteNode);
+GDWG_BENCHMARK(BM_MergeReplace);
+GDWG_BENCHMARK(BM_GetConnected);
+GDWG_BENCHMARK(BM_Iterate);
+GDWG_BENCHMARK(BM_Copy);
+GDWG_BENCHMARK(BM_Equal);
+GDWG_BENCHMARK(BM_Print);
+
+BENCHMARK_MAIN();
@@ -1,910 +1,1799 @@
-/*
-
-  == Explanation and rational of testing ==
-
-  Explain and justify how you approached testing, the degree
-   to which you're certain you have covered all possibilities,
-   and why you think your tests are that thorough.
-
-*/
-#include <string>
-#include <tuple>
-#include <utility>
-#include <vector>
-
-#include "assignments/dg/graph.h"
-#include "catch.h"
-
-// ----------------------- Commonly Used Functions -----------------------
-
-// Default Constructor
-SCENARIO("Create a Graph using the Default Constructor") {
-  GIVEN("A graph with default constructor") {
-    gdwg::Graph<std::string, int> g;
-    WHEN("size of graph is checked") {
-      std::vector<std::string> nodes = g.GetNodes();
-      THEN("size of graph should 0") { REQUIRE(nodes.size() == 0); }
-    }
-  }
-}
-
-// IsNode
-SCENARIO("Check the membership of a Node using IsNode") {
-  GIVEN("A graph with default constructor") {
-    gdwg::Graph<std::string, int> g;
-    WHEN("nodes are added") {
-      g.InsertNode("a");
-      g.InsertNode("b");
-      THEN("IsNode a and IsNode b but not IsNode c") {
-        REQUIRE(g.IsNode("a"));
-        REQUIRE(g.IsNode("b"));
-        REQUIRE(!g.IsNode("c"));
-      }
-    }
-  }
-}
-
-// InsertNode
-SCENARIO("Inserting a node into the graph") {
-  GIVEN("A graph with default constructor") {
-    gdwg::Graph<std::string, int> g;
-    WHEN("nodes are added") {
-      bool result1 = g.InsertNode("a");
-      bool result2 = g.InsertNode("b");
-      std::vector<std::string> nodes = g.GetNodes();
-      THEN("graph should contain 2 nodes") {
-        REQUIRE(nodes.size() == 2);
-        REQUIRE(nodes[0] == "a");
-        REQUIRE(nodes[1] == "b");
-        REQUIRE(result1 == true);
-        REQUIRE(result2 == true);
-      }
-    }
-    WHEN("duplicate nodes are added") {
-      bool result1 = g.InsertNode("a");
-      bool result2 = g.InsertNode("b");
-      bool result3 = g.InsertNode("a");
-      std::vector<std::string> nodes = g.GetNodes();
-      THEN("duplicate node should not be added to the graph") {
-        REQUIRE(nodes.size() == 2);
-        REQUIRE(nodes[0] == "a");
-        REQUIRE(nodes[1] == "b");
-        REQUIRE(result1 == true);
-        REQUIRE(result2 == true);
-        REQUIRE(result3 == false);
-      }
-    }
-  }
-}
-
-// IsEdge
-SCENARIO("Checking is an edge exists in the graph") {
-  GIVEN("A graph with default constructor and 2 nodes and 1 edge") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertEdge("a", "b", 5);
-    WHEN("IisEdge is called") {
-      bool result = g.isEdge("a", "b", 5);
-      THEN("result should be true") { REQUIRE(result == true); }
-    }
-
-    WHEN("IisEdge is called with non existent edge") {
-      bool result = g.isEdge("a", "b", 10);
-      THEN("result should be false") { REQUIRE(result == false); }
-    }
-  }
-}
-
-// InsertEdge
-SCENARIO("Inserting an edge into the graph") {
-  GIVEN("A graph with default constructor and 2 nodes") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    WHEN("edge is added") {
-      g.InsertEdge("a", "b", 5);
-      THEN("graph should contain 1 edge from a to b with weight 5") {
-        REQUIRE(g.isEdge("a", "b", 5) == true);
-      }
-    }
-
-    WHEN("edge with a non existent node is added") {
-      REQUIRE_THROWS_WITH(
-          g.InsertEdge("d", "b", 5),
-          "Cannot call Graph::InsertEdge when either src or dst node does not exist");
-    }
-  }
-}
-
-// GetNodes
-SCENARIO("Creating a vector of nodes in the graph") {
-  GIVEN("A graph with default constructor and 2 nodes") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    WHEN("getNodes is called") {
-      std::vector<std::string> nodes = g.GetNodes();
-      THEN("nodes vector should have 2 nodes") {
-        REQUIRE(nodes.size() == 2);
-        REQUIRE(nodes[0] == "a");
-        REQUIRE(nodes[1] == "b");
-      }
-    }
-
-    WHEN("more nodes are added") {
-      g.InsertNode("d");
-      g.InsertNode("c");
-      std::vector<std::string> nodes = g.GetNodes();
-      THEN("nodes vector should have 4 nodes in sorted order") {
-        REQUIRE(nodes.size() == 4);
-        REQUIRE(nodes[0] == "a");
-        REQUIRE(nodes[1] == "b");
-        REQUIRE(nodes[2] == "c");
-        REQUIRE(nodes[3] == "d");
-      }
-    }
-  }
-}
-
-// Equality Operator Overload
-SCENARIO("Checking if 2 graphs are equal") {
-  GIVEN("Create 2 equal graphs and 1 not equal graph") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    gdwg::Graph<std::string, int> h;
-    h.InsertNode("a");
-    h.InsertNode("b");
-    gdwg::Graph<std::string, int> i;
-    i.InsertNode("a");
-    i.InsertNode("d");
-    WHEN("equality is tested on 2 equal graphs") {
-      bool result = (g == h);
-      THEN("result should be true") { REQUIRE(result == true); }
-    }
-
-    WHEN("equality is tested on 2 not equal graphs") {
-      bool result = (g == i);
-      THEN("result should be false") { REQUIRE(result == false); }
-    }
-  }
-}
-
-// Inequality Operator Overload
-SCENARIO("Checking if 2 graphs are not equal") {
-  GIVEN("Create 2 equal graphs and 1 not equal graph") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    gdwg::Graph<std::string, int> h;
-    h.InsertNode("a");
-    h.InsertNode("b");
-    gdwg::Graph<std::string, int> i;
-    i.InsertNode("a");
-    i.InsertNode("d");
-    WHEN("inequality is tested on 2 equal graphs") {
-      bool result = (g != h);
-      THEN("result should be false") { REQUIRE(result == false); }
-    }
-
-    WHEN("inequality is tested on 2 not equal graphs") {
-      bool result = (g != i);
-      THEN("result should be true") { REQUIRE(result == true); }
-    }
-  }
-}
-
-// ----------------------- Constructors ----------------------------
-
-// Construct from vector of nodes
-SCENARIO("Create a Graph from the given vector of nodes") {
-  GIVEN("A vector of 5 int nodes") {
-    std::vector<int> vec{1, 2, 3, 4, 5};
-    WHEN("Graph is created using the begin and end iterators") {
-      gdwg::Graph<int, int> g{vec.begin(), vec.end()};
-      THEN("The nodes are the same as given by the original vector") {
-        REQUIRE(g.GetNodes() == vec);
-      }
-      THEN("There are no edges in the graph") { REQUIRE(g.cbegin() == g.cend()); }
-    }
-  }
-}
-
-// Construct from list of edges
-SCENARIO("Create a Graph from the given vector of edges") {
-  GIVEN("A vector of 5 int nodes") {
-    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
-        std::make_tuple("A", "C", 1), std::make_tuple("A", "B", 0), std::make_tuple("B", "C", 0),
-        std::make_tuple("B", "A", 4)};
-    WHEN("Graph is created using the begin and end iterators") {
-      gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
-      THEN("The edges are the sorted and  as given by the original vector") {
-        auto edge = g.cbegin();
-        REQUIRE(std::get<0>(*edge) == "A");
-        REQUIRE(std::get<1>(*edge) == "B");
-        REQUIRE(std::get<2>(*edge) == 0);
-        edge++;
-        REQUIRE(std::get<0>(*edge) == "A");
-        REQUIRE(std::get<1>(*edge) == "C");
-        REQUIRE(std::get<2>(*edge) == 1);
-        edge++;
-        REQUIRE(std::get<0>(*edge) == "B");
-        REQUIRE(std::get<1>(*edge) == "A");
-        REQUIRE(std::get<2>(*edge) == 4);
-        edge++;
-        REQUIRE(std::get<0>(*edge) == "B");
-        REQUIRE(std::get<1>(*edge) == "C");
-        REQUIRE(std::get<2>(*edge) == 0);
-        edge++;
-        REQUIRE(edge == g.cend());
-      }
-    }
-  }
-}
-
-// Construct from initialiser list of nodes
-SCENARIO("Create a Graph from the given initiliaser list of nodes") {
-  GIVEN("An initiliaser list of 5 int nodes") {
-    auto initialiser_list = {1, 2, 3, 4, 5};
-    WHEN("Graph is created using the list") {
-      gdwg::Graph<int, int> g{initialiser_list};
-      THEN("The nodes are the same as given by the initialiser list") {
-        REQUIRE(g.GetNodes() == std::vector<int>{1, 2, 3, 4, 5});
-      }
-      THEN("There are no edges in the graph") { REQUIRE(g.cbegin() == g.cend()); }
-    }
-  }
-}
-
-// Copy constructor
-SCENARIO("Create a Graph by copy constructing another graph") {
-  GIVEN("A graph with 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "c", 1);
-    WHEN("Graph is created using the copy constructor") {
-      gdwg::Graph<std::string, int> newG{g};
-      THEN("The 2 graphs are equal") { REQUIRE(g == newG); }
-    }
-  }
-}
-
-// Default Move Constructor
-SCENARIO("Create a Graph by move constructing another graph") {
-  GIVEN("A graph with 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "c", 1);
-    WHEN("Graph is created using the move constructor") {
-      gdwg::Graph<std::string, int> newG{std::move(g)};
-      THEN("The new graph has 3 nodes and 2 edges") {
-        REQUIRE(newG.IsNode("a"));
-        REQUIRE(newG.IsNode("b"));
-        REQUIRE(newG.IsNode("c"));
-        REQUIRE(newG.isEdge("b", "c", 5));
-        REQUIRE(newG.isEdge("a", "c", 1));
-      }
-      THEN("The old graph has 0 nodes and 0 edges") {
-        REQUIRE(g.GetNodes().size() == 0);
-        REQUIRE(g.cbegin() == g.cend());
-      }
-    }
-  }
-}
-
-// ----------------------- Iterator Constructors -----------------------
-
-// cbegin
-SCENARIO("Calling cbegin iterator on a graph") {
-  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "c", 1);
-    WHEN("cbegin is called") {
-      auto start = g.cbegin();
-      THEN("start must equal first edge in sorted order") {
-        REQUIRE(std::get<0>(*start) == "a");
-        REQUIRE(std::get<1>(*start) == "c");
-        REQUIRE(std::get<2>(*start) == 1);
-      }
-      start++;
-      THEN("start++ should equal next edge") {
-        REQUIRE(std::get<0>(*start) == "b");
-        REQUIRE(std::get<1>(*start) == "c");
-        REQUIRE(std::get<2>(*start) == 5);
-      }
-      start++;
-      THEN("start++ should now equal cend") { REQUIRE(start == g.cend()); }
-    }
-  }
-}
-
-// cend
-SCENARIO("Calling cend iterator on a graph") {
-  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "c", 1);
-    WHEN("cend is called") {
-      auto end = g.cend();
-      end--;
-      THEN("cend-- must equal the last edge in sorted order") {
-        REQUIRE(std::get<0>(*end) == "b");
-        REQUIRE(std::get<1>(*end) == "c");
-        REQUIRE(std::get<2>(*end) == 5);
-      }
-      end--;
-      THEN("end-- should equal now equal the cbegin") { REQUIRE(end == g.cbegin()); }
-    }
-  }
-}
-
-// begin
-SCENARIO("Calling begin iterator on a graph") {
-  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "c", 1);
-    WHEN("begin is called") {
-      auto start = g.begin();
-      THEN("start must equal first edge in sorted order") {
-        REQUIRE(std::get<0>(*start) == "a");
-        REQUIRE(std::get<1>(*start) == "c");
-        REQUIRE(std::get<2>(*start) == 1);
-      }
-      start++;
-      THEN("start++ should equal next edge") {
-        REQUIRE(std::get<0>(*start) == "b");
-        REQUIRE(std::get<1>(*start) == "c");
-        REQUIRE(std::get<2>(*start) == 5);
-      }
-      start++;
-      THEN("start++ should now equal end") { REQUIRE(start == g.end()); }
-    }
-  }
-}
-
-// end
-SCENARIO("Calling end iterator on a graph") {
-  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "c", 1);
-    WHEN("end is called") {
-      auto end = g.end();
-      end--;
-      THEN("end-- must equal the last node in sorted order") {
-        REQUIRE(std::get<0>(*end) == "b");
-        REQUIRE(std::get<1>(*end) == "c");
-        REQUIRE(std::get<2>(*end) == 5);
-      }
-      end--;
-      THEN("end-- should equal now equal the begin") { REQUIRE(end == g.begin()); }
-    }
-  }
-}
-
-// crbegin
-SCENARIO("Calling crbegin iterator on a graph") {
-  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "c", 1);
-    WHEN("crbegin is called") {
-      auto start = g.crbegin();
-      THEN("start must equal last edge in sorted order") {
-        REQUIRE(std::get<0>(*start) == "b");
-        REQUIRE(std::get<1>(*start) == "c");
-        REQUIRE(std::get<2>(*start) == 5);
-      }
-      start++;
-      THEN("start++ should equal next edge") {
-        REQUIRE(std::get<0>(*start) == "a");
-        REQUIRE(std::get<1>(*start) == "c");
-        REQUIRE(std::get<2>(*start) == 1);
-      }
-      start++;
-      THEN("start++ should now equal crend") { REQUIRE(start == g.crend()); }
-    }
-  }
-}
-
-// crend
-SCENARIO("Calling crend iterator on a graph") {
-  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "c", 1);
-    WHEN("crend is called") {
-      auto end = g.crend();
-      end--;
-      THEN("crend-- must equal the last edge in sorted order") {
-        REQUIRE(std::get<0>(*end) == "a");
-        REQUIRE(std::get<1>(*end) == "c");
-        REQUIRE(std::get<2>(*end) == 1);
-      }
-      end--;
-      THEN("end should equal now equal the crbegin") { REQUIRE(end == g.crbegin()); }
-    }
-  }
-}
-
-// rbegin
-SCENARIO("Calling rbegin iterator on a graph") {
-  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "c", 1);
-    WHEN("rbegin is called") {
-      auto start = g.rbegin();
-      THEN("start must equal last edge in sorted order") {
-        REQUIRE(std::get<0>(*start) == "b");
-        REQUIRE(std::get<1>(*start) == "c");
-        REQUIRE(std::get<2>(*start) == 5);
-      }
-      start++;
-      THEN("start++ should equal next edge") {
-        REQUIRE(std::get<0>(*start) == "a");
-        REQUIRE(std::get<1>(*start) == "c");
-        REQUIRE(std::get<2>(*start) == 1);
-      }
-      start++;
-      THEN("start++ should now equal rend") { REQUIRE(start == g.rend()); }
-    }
-  }
-}
-
-// rend
-SCENARIO("Calling rend iterator on a graph") {
-  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "c", 1);
-    WHEN("rend is called") {
-      auto end = g.rend();
-      end--;
-      THEN("crend-- must equal the last edge in sorted order") {
-        REQUIRE(std::get<0>(*end) == "a");
-        REQUIRE(std::get<1>(*end) == "c");
-        REQUIRE(std::get<2>(*end) == 1);
-      }
-      end--;
-      THEN("end should equal now equal the rbegin") { REQUIRE(end == g.rbegin()); }
-    }
-  }
-}
-
-// ----------------------- Operations ------------------------------
-
-// Copy Assignment
-SCENARIO("Create a Graph by copy assigning another graph") {
-  GIVEN("A graph with 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "c", 1);
-    WHEN("Graph is created using the copy assignment") {
-      gdwg::Graph<std::string, int> newG = g;
-      THEN("The 2 graphs are equal") { REQUIRE(g == newG); }
-    }
-  }
-}
-
-// Move Assignment
-SCENARIO("Create a Graph by move assigning another graph") {
-  GIVEN("A graph with 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "c", 1);
-    WHEN("Graph is created using the move assignment") {
-      gdwg::Graph<std::string, int> newG = std::move(g);
-      THEN("The new graph has 3 nodes and 2 edges") {
-        REQUIRE(newG.IsNode("a"));
-        REQUIRE(newG.IsNode("b"));
-        REQUIRE(newG.IsNode("c"));
-        REQUIRE(newG.isEdge("b", "c", 5));
-        REQUIRE(newG.isEdge("a", "c", 1));
-      }
-      THEN("The old graph has 0 nodes and 0 edges") {
-        REQUIRE(g.GetNodes().size() == 0);
-        REQUIRE(g.cbegin() == g.cend());
-      }
-    }
-  }
-}
-
-// ----------------------- Methods ---------------------------------
-
-// DeleteNode
-SCENARIO("Deleting a Node from a Graph") {
-  GIVEN("A graph with 4 edges and 4 nodes") {
-    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
-        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2), std::make_tuple("C", "D", 3),
-        std::make_tuple("D", "A", 4)};
-    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
-    WHEN("Node A is Deleted") {
-      bool result = g.DeleteNode("A");
-      THEN("A is actually deleted") { REQUIRE(result); }
-      THEN("There are only 3 nodes now") { REQUIRE(g.GetNodes().size() == 3); }
-      THEN("A is not a node") { REQUIRE(!g.IsNode("A")); }
-      THEN("There are no edges that start or end in A") {
-        for (auto edge = g.cbegin(); edge != g.cend(); edge++) {
-          REQUIRE(std::get<0>(*edge) != "A");
-          REQUIRE(std::get<1>(*edge) != "A");
-        }
-      }
-    }
-    WHEN("Node E is Deleted") {
-      bool result = g.DeleteNode("E");
-      THEN("E is NOT actually deleted") { REQUIRE(!result); }
-      THEN("There are only 4 nodes still") { REQUIRE(g.GetNodes().size() == 4); }
-    }
-  }
-}
-
-// Replace
-SCENARIO("Replacing a Node in a Graph") {
-  GIVEN("A graph with 4 edges and 4 nodes") {
-    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
-        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2), std::make_tuple("C", "D", 3),
-        std::make_tuple("D", "A", 4)};
-    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
-    WHEN("Node A is replaced with E") {
-      bool replaced = g.Replace("A", "E");
-      THEN("The node is actually replaced") { REQUIRE(replaced); }
-      THEN("There are only 4 nodes still") { REQUIRE(g.GetNodes().size() == 4); }
-      THEN("A is not a node") { REQUIRE(!g.IsNode("A")); }
-      THEN("There are no edges that start or end in A") {
-        for (auto edge = g.cbegin(); edge != g.cend(); edge++) {
-          REQUIRE(std::get<0>(*edge) != "A");
-          REQUIRE(std::get<1>(*edge) != "A");
-        }
-      }
-      THEN("E is a node") { REQUIRE(g.IsNode("E")); }
-      THEN("There is an edge from E->B(1) and D->E(4)") {
-        REQUIRE(g.isEdge("E", "B", 1));
-        REQUIRE(g.isEdge("D", "E", 4));
-      }
-    }
-    WHEN("Node A is replaced with B") {
-      bool replaced = g.Replace("A", "B");
-      THEN("The node is not actually replaced") { REQUIRE(!replaced); }
-      THEN("There are still 4 nodes") { REQUIRE(g.GetNodes().size() == 4); }
-      THEN("B is a node") { REQUIRE(g.IsNode("B")); }
-      THEN("A is a node") { REQUIRE(g.IsNode("A")); }
-      THEN("There is an edge from A->B(1) and D->A(4)") {
-        REQUIRE(g.isEdge("A", "B", 1));
-        REQUIRE(g.isEdge("D", "A", 4));
-      }
-    }
-    WHEN("Node F is rpelaced with B") {
-      REQUIRE_THROWS_WITH(g.Replace("F", "B"),
-                          "Cannot call Graph::Replace on a node that doesn't exist");
-    }
-  }
-}
-
-// MergeReplace
-SCENARIO("Merge Replacing a Node in a Graph") {
-  GIVEN("A graph with 4 edges and 4 nodes") {
-    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
-        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2), std::make_tuple("C", "D", 3),
-        std::make_tuple("D", "A", 4)};
-    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
-    WHEN("Node A is replaced with B") {
-      g.MergeReplace("A", "B");
-      THEN("There are only 3 nodes now") { REQUIRE(g.GetNodes().size() == 3); }
-      THEN("A is not a node") { REQUIRE(!g.IsNode("A")); }
-      THEN("There are no edges that start or end in A") {
-        for (auto edge = g.cbegin(); edge != g.cend(); edge++) {
-          REQUIRE(std::get<0>(*edge) != "A");
-          REQUIRE(std::get<1>(*edge) != "A");
-        }
-      }
-      THEN("There is an edge from B->B(1) and D->A(4)") {
-        REQUIRE(g.isEdge("B", "B", 1));
-        REQUIRE(g.isEdge("D", "B", 4));
-      }
-    }
-    WHEN("Node A is replaced with B") {
-      g.MergeReplace("A", "B");
-      THEN("There are only 3 nodes now") { REQUIRE(g.GetNodes().size() == 3); }
-      THEN("A is not a node") { REQUIRE(!g.IsNode("A")); }
-      THEN("There are no edges that start or end in A") {
-        for (auto edge = g.cbegin(); edge != g.cend(); edge++) {
-          REQUIRE(std::get<0>(*edge) != "A");
-          REQUIRE(std::get<1>(*edge) != "A");
-        }
-      }
-      THEN("There is an edge from B->B(1) and D->A(4)") {
-        REQUIRE(g.isEdge("B", "B", 1));
-        REQUIRE(g.isEdge("D", "B", 4));
-      }
-    }
-    WHEN("There is an edge from A->A(1) and A->B(1)") {
-      g.InsertEdge("A", "A", 1);
-      AND_WHEN("Node A is replaced by Node B") {
-        g.MergeReplace("A", "B");
-        THEN("There are only 3 nodes now") { REQUIRE(g.GetNodes().size() == 3); }
-        THEN("A is not a node") { REQUIRE(!g.IsNode("A")); }
-        THEN("There are no edges that start or end in A") {
-          for (auto edge = g.cbegin(); edge != g.cend(); edge++) {
-            REQUIRE(std::get<0>(*edge) != "A");
-            REQUIRE(std::get<1>(*edge) != "A");
-          }
-        }
-        THEN("There is an edge from B->B(1) and D->A(4)") {
-          REQUIRE(g.isEdge("B", "B", 1));
-          REQUIRE(g.isEdge("D", "B", 4));
-        }
-        THEN("There is only one edge from B->B(1) (duplicate not added)") {
-          REQUIRE(g.GetWeights("B", "B").size() == 1);
-        }
-      }
-    }
-    WHEN("Node E is rpelaced with B") {
-      REQUIRE_THROWS_WITH(
-          g.MergeReplace("E", "B"),
-          "Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph");
-    }
-    WHEN("Node B is rpelaced with E") {
-      REQUIRE_THROWS_WITH(
-          g.MergeReplace("B", "E"),
-          "Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph");
-    }
-  }
-}
-
-// Clear
-SCENARIO("Clearing a Graph") {
-  GIVEN("A graph with 4 edges and 4 nodes") {
-    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
-        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2), std::make_tuple("C", "D", 3),
-        std::make_tuple("D", "A", 4)};
-    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
-    WHEN("The graph is cleared") {
-      g.Clear();
-      THEN("The graph is same as a new graph with no edges and no nodes") {
-        gdwg::Graph<std::string, int> clearG;
-        REQUIRE(g == clearG);
-      }
-
-      THEN("New nodes should be able to be inserted") {
-        g.InsertNode("a");
-        g.InsertNode("b");
-        auto nodes = g.GetNodes();
-        REQUIRE(nodes.size() == 2);
-        REQUIRE(nodes[0] == "a");
-        REQUIRE(nodes[1] == "b");
-      }
-    }
-  }
-}
-
-// IsConnected
-SCENARIO("Checking connectivity of 2 nodes in a Graph") {
-  GIVEN("A graph with 4 edges and 4 nodes") {
-    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
-        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2), std::make_tuple("C", "D", 3),
-        std::make_tuple("D", "A", 4)};
-    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
-    WHEN("The connectivity from A to B is Tested") {
-      bool connected = g.IsConnected("A", "B");
-      THEN("A and B are connected from A to B") { REQUIRE(connected); }
-    }
-    WHEN("The connectivity from B to A is Tested") {
-      bool connected = g.IsConnected("B", "A");
-      THEN("A and B are not connected from B to A") { REQUIRE(!connected); }
-    }
-    WHEN("The connectivity from E to A is Tested") {
-      REQUIRE_THROWS_WITH(
-          g.IsConnected("E", "A"),
-          "Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
-    }
-    WHEN("The connectivity from A to E is Tested") {
-      REQUIRE_THROWS_WITH(
-          g.IsConnected("A", "E"),
-          "Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
-    }
-  }
-}
-
-// GetConnected
-SCENARIO("Getting nodes connected to a given node") {
-  GIVEN("A graph with 4 edges and 4 nodes, 1 Node from A and 0 nodes from D") {
-    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
-        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2), std::make_tuple("C", "D", 3),
-        std::make_tuple("B", "A", 4)};
-    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
-    WHEN("The connected nodes of A are received") {
-      auto connectedNodes = g.GetConnected("A");
-      THEN("There is one node in the list and it is B") {
-        REQUIRE(connectedNodes.size() == 1);
-        REQUIRE(connectedNodes[0] == "B");
-      }
-    }
-    WHEN("The connected nodes of D are received") {
-      auto connectedNodes = g.GetConnected("D");
-      THEN("There is no nodes in the list") { REQUIRE(connectedNodes.size() == 0); }
-    }
-    WHEN("The connected nodes of A are received") {
-      REQUIRE_THROWS_WITH(g.GetConnected("E"),
-                          "Cannot call Graph::GetConnected if src doesn't exist in the graph");
-    }
-  }
-}
-
-// GetWeights
-SCENARIO("Getting weights for edges between 2 given nodes") {
-  GIVEN("A graph with 4 edges and 4 nodes") {
-    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
-        std::make_tuple("A", "B", 1), std::make_tuple("A", "B", -1), std::make_tuple("A", "B", 5),
-        std::make_tuple("A", "B", 4)};
-    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
-    WHEN("The weights of edges from A->B are received") {
-      auto weights = g.GetWeights("A", "B");
-      THEN("There are 4 weights") { REQUIRE(weights.size() == 4); }
-      THEN("The weights are sorted") {
-        auto sortedWeights = weights;
-        std::sort(sortedWeights.begin(), sortedWeights.end());
-        REQUIRE(weights == sortedWeights);
-      }
-    }
-    WHEN("The weights from A to E are received") {
-      REQUIRE_THROWS_WITH(
-          g.GetWeights("A", "E"),
-          "Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
-    }
-    WHEN("The weights from E to A are received") {
-      REQUIRE_THROWS_WITH(
-          g.GetWeights("E", "A"),
-          "Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
-    }
-  }
-}
-
-// erase
-SCENARIO("Erase an edge from the internal representation") {
-  GIVEN("A graph with 4 edges and 4 nodes") {
-    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
-        std::make_tuple("A", "B", 1), std::make_tuple("A", "B", -1), std::make_tuple("A", "B", 5),
-        std::make_tuple("A", "B", 4)};
-    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
-    WHEN("The edge A->B(1) is erased") {
-      auto erased = g.erase("A", "B", 1);
-      THEN("A->B(1) actually got deleted") { REQUIRE(erased); }
-      THEN("A->B(1) does not exist anymore") { REQUIRE(!g.isEdge("A", "B", 1)); }
-      THEN("A->B(-1) still exists") { REQUIRE(g.isEdge("A", "B", -1)); }
-      THEN("A->B(5) still exists") { REQUIRE(g.isEdge("A", "B", 5)); }
-      THEN("A->B(4) still exists") { REQUIRE(g.isEdge("A", "B", 4)); }
-    }
-    WHEN("The edge B->B(1) is erased") {
-      auto erased = g.erase("B", "B", 1);
-      THEN("B->B(1) did not delete because it does not exist") { REQUIRE(!erased); }
-    }
-  }
-}
-
-// Iterator find
-SCENARIO("Finding a particular edge in the graph") {
-  GIVEN("A graph with 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "b", 1);
-    WHEN("find is called") {
-      auto it = g.find("a", "b", 1);
-      THEN("iterator should point to the edge from a to b with weight 1") {
-        REQUIRE(std::get<0>(*it) == "a");
-        REQUIRE(std::get<1>(*it) == "b");
-        REQUIRE(std::get<2>(*it) == 1);
-      }
-    }
-
-    WHEN("find is called for a edge that does not exist") {
-      auto it = g.find("a", "c", 2);
-      THEN("iterator should equal cend") { REQUIRE(it == g.cend()); }
-    }
-  }
-}
-
-// Iterator erase
-SCENARIO("Erasing an edge using an iterator in the graph") {
-  GIVEN("A graph with 3 nodes and 2 edges") {
-    gdwg::Graph<std::string, int> g;
-    g.InsertNode("a");
-    g.InsertNode("b");
-    g.InsertNode("c");
-    g.InsertEdge("b", "c", 5);
-    g.InsertEdge("a", "b", 1);
-    auto it = g.find("a", "b", 1);
-    WHEN("erase is called") {
-      it = g.erase(it);
-      THEN("edge should be erased and iterator should point to next edge") {
-        REQUIRE(g.isEdge("a", "b", 1) == false);
-        REQUIRE(std::get<0>(*it) == "b");
-        REQUIRE(std::get<1>(*it) == "c");
-        REQUIRE(std::get<2>(*it) == 5);
-      }
-    }
-
-    WHEN("erase is called for a edge that does not exist") {
-      auto it = g.find("a", "b", 2);
-      it = g.erase(it);
-      THEN("iterator should equal cend") { REQUIRE(it == g.cend()); }
-    }
-  }
-}
-
-// ----------------------- Friends ---------------------------------
-
-// Outstream Operator Overload
-SCENARIO("Print a graph using the output stream") {
-  GIVEN("A graph with 4 edges and 4 nodes") {
-    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
-        std::make_tuple("B", "D", 5), std::make_tuple("B", "C", -1), std::make_tuple("C", "D", 4),
-        std::make_tuple("A", "B", 1)};
-    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
-    WHEN("It is printed using the output stream") {
-      std::stringstream v;
-      v << g;
-      THEN("Then it is printed in the following format:\n[node1][1 space](\n[2 "
-           "spaces][node1_connected_node1][1 space][pipe][1 space][weight]\n[2 "
-           "spaces][node1_connected_node2][1 space][pipe][1 space][weight]\n[etc "
-           "etc]\n)\n[node2][1 space](\n[2 spaces][node2_connected_node1][1 space][pipe][1 "
-           "space][weight]\n[2 spaces][node2_connected_node2][1 space][pipe][1 "
-           "space][weight]\n[etc etc]\n)\n[node3][1 space](\n[2 spaces][node3_connected_node1][1 "
-           "space][pipe][1 space][weight]\n[2 spaces][node3_connected_node2][1 space][pipe][1 "
-           "space][weight]\n[etc etc]\n)\n[etc etc]\n"
-           "sorted first by node, then by connected node and then by weight") {
-        REQUIRE(v.str() == "A (\n  B | 1\n)\nB (\n  C | -1\n  D | 5\n)\nC (\n  D | 4\n)\nD (\n)\n");
-      }
-    }
-  }
-  GIVEN("An empty graph is created") {
-    gdwg::Graph<std::string, int> g;
-    WHEN("It is printed using the output stream") {
-      std::stringstream v;
-      v << g;
-      THEN("Then the output is empty") { REQUIRE(v.str() == ""); }
-    }
-  }
-}
+/*
+
+  == Explanation and rational of testing ==
+
+  Explain and justify how you approached testing, the degree
+   to which you're certain you have covered all possibilities,
+   and why you think your tests are that thorough.
+
+*/
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <memory_resource>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "catch.h"
+
+// Node type with an ordering but no std::hash specialisation
+struct OrderedOnly {
+  int value;
+  friend bool operator==(const OrderedOnly& a, const OrderedOnly& b) { return a.value == b.value; }
+  friend bool operator<(const OrderedOnly& a, const OrderedOnly& b) { return a.value < b.value; }
+};
+
+// Value type that counts how often it is copied
+struct CopyCounter {
+  explicit CopyCounter(int v) : value{v} {}
+  CopyCounter(const CopyCounter& other) : value{other.value} { ++copies; }
+  CopyCounter(CopyCounter&&) = default;
+  CopyCounter& operator=(const CopyCounter& other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  CopyCounter& operator=(CopyCounter&&) = default;
+  friend bool operator==(const CopyCounter& a, const CopyCounter& b) { return a.value == b.value; }
+  friend bool operator<(const CopyCounter& a, const CopyCounter& b) { return a.value < b.value; }
+
+  int value;
+  static int copies;
+};
+int CopyCounter::copies = 0;
+
+// ----------------------- Commonly Used Functions -----------------------
+
+// Default Constructor
+SCENARIO("Create a Graph using the Default Constructor") {
+  GIVEN("A graph with default constructor") {
+    gdwg::Graph<std::string, int> g;
+    WHEN("size of graph is checked") {
+      std::vector<std::string> nodes = g.GetNodes();
+      THEN("size of graph should 0") { REQUIRE(nodes.size() == 0); }
+    }
+  }
+}
+
+// IsNode
+SCENARIO("Check the membership of a Node using IsNode") {
+  GIVEN("A graph with default constructor") {
+    gdwg::Graph<std::string, int> g;
+    WHEN("nodes are added") {
+      g.InsertNode("a");
+      g.InsertNode("b");
+      THEN("IsNode a and IsNode b but not IsNode c") {
+        REQUIRE(g.IsNode("a"));
+        REQUIRE(g.IsNode("b"));
+        REQUIRE(!g.IsNode("c"));
+      }
+    }
+  }
+}
+
+// InsertNode
+SCENARIO("Inserting a node into the graph") {
+  GIVEN("A graph with default constructor") {
+    gdwg::Graph<std::string, int> g;
+    WHEN("nodes are added") {
+      bool result1 = g.InsertNode("a");
+      bool result2 = g.InsertNode("b");
+      std::vector<std::string> nodes = g.GetNodes();
+      THEN("graph should contain 2 nodes") {
+        REQUIRE(nodes.size() == 2);
+        REQUIRE(nodes[0] == "a");
+        REQUIRE(nodes[1] == "b");
+        REQUIRE(result1 == true);
+        REQUIRE(result2 == true);
+      }
+    }
+    WHEN("duplicate nodes are added") {
+      bool result1 = g.InsertNode("a");
+      bool result2 = g.InsertNode("b");
+      bool result3 = g.InsertNode("a");
+      std::vector<std::string> nodes = g.GetNodes();
+      THEN("duplicate node should not be added to the graph") {
+        REQUIRE(nodes.size() == 2);
+        REQUIRE(nodes[0] == "a");
+        REQUIRE(nodes[1] == "b");
+        REQUIRE(result1 == true);
+        REQUIRE(result2 == true);
+        REQUIRE(result3 == false);
+      }
+    }
+  }
+}
+
+// Node Index
+SCENARIO("Looking up nodes of a type that cannot be hashed") {
+  GIVEN("A graph whose nodes only support ordering") {
+    gdwg::Graph<OrderedOnly, int> g;
+    g.InsertNode({2});
+    g.InsertNode({1});
+    g.InsertEdge({1}, {2}, 3);
+    WHEN("nodes are looked up, replaced and deleted") {
+      bool duplicate = g.InsertNode({1});
+      bool replaced = g.Replace({2}, {5});
+      THEN("the ordered index keeps track of every node") {
+        REQUIRE(duplicate == false);
+        REQUIRE(replaced == true);
+        REQUIRE(!g.IsNode({2}));
+        REQUIRE(g.IsNode({5}));
+        REQUIRE(g.IsConnected({1}, {5}));
+        REQUIRE(g.DeleteNode({1}));
+        REQUIRE(g.GetNodes().size() == 1);
+      }
+    }
+  }
+}
+
+// IsEdge
+SCENARIO("Working with nodes through NodeId handles") {
+  GIVEN("A graph with handles to nodes A, B and C and an edge from A to B") {
+    gdwg::Graph<std::string, int> g;
+    auto a = g.InsertNodeId("A");
+    auto b = g.InsertNodeId("B");
+    auto c = g.InsertNodeId("C");
+    g.InsertEdge(a, b, 1);
+    WHEN("the graph is queried by handle") {
+      THEN("the results match the ones by value") {
+        REQUIRE(g.InsertNodeId("A") == a);
+        REQUIRE(g.GetNodeId("B") == b);
+        REQUIRE(g.GetNode(c) == "C");
+        REQUIRE(g.IsConnected(a, b));
+        REQUIRE(!g.IsConnected(b, a));
+        REQUIRE(g.GetConnected(a) == std::vector<gdwg::NodeId>{b});
+        REQUIRE(g.GetWeights(a, b) == std::vector<int>{1});
+        REQUIRE(!g.InsertEdge(a, b, 1));
+      }
+    }
+    WHEN("other nodes are changed and A is replaced") {
+      g.DeleteNode("C");
+      g.InsertNode("D");
+      g.Replace("A", "Z");
+      THEN("the handle to A follows the node") {
+        REQUIRE(g.IsNode(a));
+        REQUIRE(g.GetNode(a) == "Z");
+        REQUIRE(g.IsConnected(a, b));
+      }
+    }
+    WHEN("B is deleted and a new node reuses its slot") {
+      g.DeleteNode("B");
+      auto d = g.InsertNodeId("D");
+      THEN("the handle to B is not valid and does not refer to the new node") {
+        REQUIRE(!g.IsNode(b));
+        REQUIRE(b != d);
+        REQUIRE(!g.erase(a, b, 1));
+        REQUIRE_THROWS_WITH(g.GetNode(b),
+                            "Cannot call Graph::GetNode with a NodeId that is not valid");
+        REQUIRE_THROWS_WITH(
+            g.InsertEdge(a, b, 2),
+            "Cannot call Graph::InsertEdge when either src or dst node does not exist");
+      }
+    }
+    WHEN("B is merged into C") {
+      g.MergeReplace("B", "C");
+      THEN("the handle to B is not valid and the edge is on C") {
+        REQUIRE(!g.IsNode(b));
+        REQUIRE(g.IsConnected(a, c));
+      }
+    }
+    WHEN("the graph is cleared") {
+      g.Clear();
+      THEN("no handle is valid") {
+        REQUIRE(!g.IsNode(a));
+        REQUIRE(!g.IsNode(gdwg::NodeId{}));
+      }
+    }
+    WHEN("the graph is copied and an edge is erased by handle from the copy") {
+      auto copy = g;
+      REQUIRE(copy.erase(a, b, 1));
+      THEN("the handles work on both graphs and only the copy loses the edge") {
+        REQUIRE(copy.GetNode(a) == "A");
+        REQUIRE(!copy.IsConnected(a, b));
+        REQUIRE(g.IsConnected(a, b));
+      }
+    }
+  }
+}
+
+SCENARIO("Checking is an edge exists in the graph") {
+  GIVEN("A graph with default constructor and 2 nodes and 1 edge") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertEdge("a", "b", 5);
+    WHEN("IisEdge is called") {
+      bool result = g.isEdge("a", "b", 5);
+      THEN("result should be true") { REQUIRE(result == true); }
+    }
+
+    WHEN("IisEdge is called with non existent edge") {
+      bool result = g.isEdge("a", "b", 10);
+      THEN("result should be false") { REQUIRE(result == false); }
+    }
+  }
+}
+
+// Move and Emplace Insertion
+SCENARIO("Moving and emplacing values into the graph") {
+  GIVEN("A graph whose nodes and weights count their copies") {
+    gdwg::Graph<CopyCounter, CopyCounter> g;
+    CopyCounter::copies = 0;
+    WHEN("nodes, edges and replacements are moved or emplaced in") {
+      bool inserted = g.InsertNode(CopyCounter{1});
+      bool emplaced = g.EmplaceNode(2);
+      bool duplicate = g.EmplaceNode(1);
+      g.InsertEdge(CopyCounter{1}, CopyCounter{2}, CopyCounter{3});
+      bool replaced = g.Replace(CopyCounter{2}, CopyCounter{4});
+      THEN("nothing is copied into the graph") {
+        REQUIRE(inserted);
+        REQUIRE(emplaced);
+        REQUIRE(!duplicate);
+        REQUIRE(replaced);
+        REQUIRE(g.isEdge(CopyCounter{1}, CopyCounter{4}, CopyCounter{3}));
+        REQUIRE(CopyCounter::copies == 0);
+      }
+    }
+  }
+}
+
+// InsertEdge
+SCENARIO("Inserting an edge into the graph") {
+  GIVEN("A graph with default constructor and 2 nodes") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    WHEN("edge is added") {
+      g.InsertEdge("a", "b", 5);
+      THEN("graph should contain 1 edge from a to b with weight 5") {
+        REQUIRE(g.isEdge("a", "b", 5) == true);
+      }
+    }
+
+    WHEN("edge with a non existent node is added") {
+      REQUIRE_THROWS_WITH(
+          g.InsertEdge("d", "b", 5),
+          "Cannot call Graph::InsertEdge when either src or dst node does not exist");
+    }
+  }
+}
+
+// GetNodes
+SCENARIO("Creating a vector of nodes in the graph") {
+  GIVEN("A graph with default constructor and 2 nodes") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    WHEN("getNodes is called") {
+      std::vector<std::string> nodes = g.GetNodes();
+      THEN("nodes vector should have 2 nodes") {
+        REQUIRE(nodes.size() == 2);
+        REQUIRE(nodes[0] == "a");
+        REQUIRE(nodes[1] == "b");
+      }
+    }
+
+    WHEN("more nodes are added") {
+      g.InsertNode("d");
+      g.InsertNode("c");
+      std::vector<std::string> nodes = g.GetNodes();
+      THEN("nodes vector should have 4 nodes in sorted order") {
+        REQUIRE(nodes.size() == 4);
+        REQUIRE(nodes[0] == "a");
+        REQUIRE(nodes[1] == "b");
+        REQUIRE(nodes[2] == "c");
+        REQUIRE(nodes[3] == "d");
+      }
+    }
+  }
+}
+
+// Equality Operator Overload
+SCENARIO("Checking if 2 graphs are equal") {
+  GIVEN("Create 2 equal graphs and 1 not equal graph") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    gdwg::Graph<std::string, int> h;
+    h.InsertNode("a");
+    h.InsertNode("b");
+    gdwg::Graph<std::string, int> i;
+    i.InsertNode("a");
+    i.InsertNode("d");
+    WHEN("equality is tested on 2 equal graphs") {
+      bool result = (g == h);
+      THEN("result should be true") { REQUIRE(result == true); }
+    }
+
+    WHEN("equality is tested on 2 not equal graphs") {
+      bool result = (g == i);
+      THEN("result should be false") { REQUIRE(result == false); }
+    }
+
+    WHEN("equality is tested on graphs whose edges were inserted in different orders") {
+      g.InsertEdge("a", "b", 1);
+      g.InsertEdge("b", "a", 2);
+      h.InsertEdge("b", "a", 2);
+      h.InsertEdge("a", "b", 1);
+      bool same = (g == h);
+      h.erase("a", "b", 1);
+      h.InsertEdge("a", "b", 3);
+      bool differentWeight = (g == h);
+      THEN("only the graphs with the same edges are equal") {
+        REQUIRE(same == true);
+        REQUIRE(differentWeight == false);
+      }
+    }
+  }
+}
+
+// Inequality Operator Overload
+SCENARIO("Checking if 2 graphs are not equal") {
+  GIVEN("Create 2 equal graphs and 1 not equal graph") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    gdwg::Graph<std::string, int> h;
+    h.InsertNode("a");
+    h.InsertNode("b");
+    gdwg::Graph<std::string, int> i;
+    i.InsertNode("a");
+    i.InsertNode("d");
+    WHEN("inequality is tested on 2 equal graphs") {
+      bool result = (g != h);
+      THEN("result should be false") { REQUIRE(result == false); }
+    }
+
+    WHEN("inequality is tested on 2 not equal graphs") {
+      bool result = (g != i);
+      THEN("result should be true") { REQUIRE(result == true); }
+    }
+  }
+}
+
+// ----------------------- Constructors ----------------------------
+
+// Construct from vector of nodes
+SCENARIO("Create a Graph from the given vector of nodes") {
+  GIVEN("A vector of 5 int nodes") {
+    std::vector<int> vec{1, 2, 3, 4, 5};
+    WHEN("Graph is created using the begin and end iterators") {
+      gdwg::Graph<int, int> g{vec.begin(), vec.end()};
+      THEN("The nodes are the same as given by the original vector") {
+        REQUIRE(g.GetNodes() == vec);
+      }
+      THEN("There are no edges in the graph") { REQUIRE(g.cbegin() == g.cend()); }
+    }
+  }
+}
+
+// Construct from list of edges
+SCENARIO("Create a Graph from the given vector of edges") {
+  GIVEN("A vector of 5 int nodes") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("A", "C", 1), std::make_tuple("A", "B", 0), std::make_tuple("B", "C", 0),
+        std::make_tuple("B", "A", 4)};
+    WHEN("Graph is created using the begin and end iterators") {
+      gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
+      THEN("The edges are the sorted and  as given by the original vector") {
+        auto edge = g.cbegin();
+        REQUIRE(std::get<0>(*edge) == "A");
+        REQUIRE(std::get<1>(*edge) == "B");
+        REQUIRE(std::get<2>(*edge) == 0);
+        edge++;
+        REQUIRE(std::get<0>(*edge) == "A");
+        REQUIRE(std::get<1>(*edge) == "C");
+        REQUIRE(std::get<2>(*edge) == 1);
+        edge++;
+        REQUIRE(std::get<0>(*edge) == "B");
+        REQUIRE(std::get<1>(*edge) == "A");
+        REQUIRE(std::get<2>(*edge) == 4);
+        edge++;
+        REQUIRE(std::get<0>(*edge) == "B");
+        REQUIRE(std::get<1>(*edge) == "C");
+        REQUIRE(std::get<2>(*edge) == 0);
+        edge++;
+        REQUIRE(edge == g.cend());
+      }
+    }
+  }
+}
+
+// Construct from any range of edges
+SCENARIO("Create a Graph from ranges and input iterators of edges") {
+  GIVEN("A list of edges with a duplicate") {
+    std::list<std::tuple<std::string, std::string, int>> listTuples{
+        std::make_tuple("B", "A", 4), std::make_tuple("A", "B", 0), std::make_tuple("B", "A", 4)};
+    WHEN("Graph is created by moving the list in") {
+      gdwg::Graph<std::string, int> g{std::move(listTuples)};
+      THEN("The duplicate edge is only added once") {
+        REQUIRE(g.GetNodes() == std::vector<std::string>{"A", "B"});
+        REQUIRE(g.GetWeights("B", "A") == std::vector<int>{4});
+        REQUIRE(g.GetConnected("A") == std::vector<std::string>{"B"});
+        REQUIRE(std::distance(g.cbegin(), g.cend()) == 2);
+      }
+    }
+  }
+  GIVEN("A stream of edges") {
+    std::istringstream in{"1 2 3\n2 1 3\n1 1 2\n"};
+    auto readEdge = [&in]() {
+      int src, dst, weight;
+      in >> src >> dst >> weight;
+      return std::make_tuple(src, dst, weight);
+    };
+    std::vector<std::tuple<int, int, int>> edges{readEdge(), readEdge(), readEdge()};
+    WHEN("Graph is created using input iterators") {
+      std::istringstream numbers{"3 1 2"};
+      gdwg::Graph<int, int> nodes{std::istream_iterator<int>{numbers},
+                                  std::istream_iterator<int>{}};
+      gdwg::Graph<int, int> g{edges};
+      THEN("Nodes and edges are loaded from them") {
+        REQUIRE(nodes.GetNodes() == std::vector<int>{1, 2, 3});
+        REQUIRE(g.GetConnected(1) == std::vector<int>{1, 2});
+        REQUIRE(g.IsConnected(2, 1));
+      }
+    }
+  }
+}
+
+// Construct from initialiser list of nodes
+SCENARIO("Create a Graph from the given initiliaser list of nodes") {
+  GIVEN("An initiliaser list of 5 int nodes") {
+    auto initialiser_list = {1, 2, 3, 4, 5};
+    WHEN("Graph is created using the list") {
+      gdwg::Graph<int, int> g{initialiser_list};
+      THEN("The nodes are the same as given by the initialiser list") {
+        REQUIRE(g.GetNodes() == std::vector<int>{1, 2, 3, 4, 5});
+      }
+      THEN("There are no edges in the graph") { REQUIRE(g.cbegin() == g.cend()); }
+    }
+  }
+}
+
+// Copy constructor
+SCENARIO("Create a Graph by copy constructing another graph") {
+  GIVEN("A graph with 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "c", 1);
+    WHEN("Graph is created using the copy constructor") {
+      gdwg::Graph<std::string, int> newG{g};
+      THEN("The 2 graphs are equal") { REQUIRE(g == newG); }
+    }
+  }
+}
+
+// Default Move Constructor
+SCENARIO("Create a Graph by move constructing another graph") {
+  GIVEN("A graph with 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "c", 1);
+    WHEN("Graph is created using the move constructor") {
+      gdwg::Graph<std::string, int> newG{std::move(g)};
+      THEN("The new graph has 3 nodes and 2 edges") {
+        REQUIRE(newG.IsNode("a"));
+        REQUIRE(newG.IsNode("b"));
+        REQUIRE(newG.IsNode("c"));
+        REQUIRE(newG.isEdge("b", "c", 5));
+        REQUIRE(newG.isEdge("a", "c", 1));
+      }
+      THEN("The old graph has 0 nodes and 0 edges") {
+        REQUIRE(g.GetNodes().size() == 0);
+        REQUIRE(g.cbegin() == g.cend());
+      }
+    }
+  }
+}
+
+// ----------------------- Iterator Constructors -----------------------
+
+// cbegin
+SCENARIO("Calling cbegin iterator on a graph") {
+  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "c", 1);
+    WHEN("cbegin is called") {
+      auto start = g.cbegin();
+      THEN("start must equal first edge in sorted order") {
+        REQUIRE(std::get<0>(*start) == "a");
+        REQUIRE(std::get<1>(*start) == "c");
+        REQUIRE(std::get<2>(*start) == 1);
+      }
+      start++;
+      THEN("start++ should equal next edge") {
+        REQUIRE(std::get<0>(*start) == "b");
+        REQUIRE(std::get<1>(*start) == "c");
+        REQUIRE(std::get<2>(*start) == 5);
+      }
+      start++;
+      THEN("start++ should now equal cend") { REQUIRE(start == g.cend()); }
+    }
+  }
+}
+
+// cend
+SCENARIO("Calling cend iterator on a graph") {
+  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "c", 1);
+    WHEN("cend is called") {
+      auto end = g.cend();
+      end--;
+      THEN("cend-- must equal the last edge in sorted order") {
+        REQUIRE(std::get<0>(*end) == "b");
+        REQUIRE(std::get<1>(*end) == "c");
+        REQUIRE(std::get<2>(*end) == 5);
+      }
+      end--;
+      THEN("end-- should equal now equal the cbegin") { REQUIRE(end == g.cbegin()); }
+    }
+  }
+}
+
+// begin
+SCENARIO("Calling begin iterator on a graph") {
+  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "c", 1);
+    WHEN("begin is called") {
+      auto start = g.begin();
+      THEN("start must equal first edge in sorted order") {
+        REQUIRE(std::get<0>(*start) == "a");
+        REQUIRE(std::get<1>(*start) == "c");
+        REQUIRE(std::get<2>(*start) == 1);
+      }
+      start++;
+      THEN("start++ should equal next edge") {
+        REQUIRE(std::get<0>(*start) == "b");
+        REQUIRE(std::get<1>(*start) == "c");
+        REQUIRE(std::get<2>(*start) == 5);
+      }
+      start++;
+      THEN("start++ should now equal end") { REQUIRE(start == g.end()); }
+    }
+  }
+}
+
+// end
+SCENARIO("Calling end iterator on a graph") {
+  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "c", 1);
+    WHEN("end is called") {
+      auto end = g.end();
+      end--;
+      THEN("end-- must equal the last node in sorted order") {
+        REQUIRE(std::get<0>(*end) == "b");
+        REQUIRE(std::get<1>(*end) == "c");
+        REQUIRE(std::get<2>(*end) == 5);
+      }
+      end--;
+      THEN("end-- should equal now equal the begin") { REQUIRE(end == g.begin()); }
+    }
+  }
+}
+
+// crbegin
+SCENARIO("Calling crbegin iterator on a graph") {
+  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "c", 1);
+    WHEN("crbegin is called") {
+      auto start = g.crbegin();
+      THEN("start must equal last edge in sorted order") {
+        REQUIRE(std::get<0>(*start) == "b");
+        REQUIRE(std::get<1>(*start) == "c");
+        REQUIRE(std::get<2>(*start) == 5);
+      }
+      start++;
+      THEN("start++ should equal next edge") {
+        REQUIRE(std::get<0>(*start) == "a");
+        REQUIRE(std::get<1>(*start) == "c");
+        REQUIRE(std::get<2>(*start) == 1);
+      }
+      start++;
+      THEN("start++ should now equal crend") { REQUIRE(start == g.crend()); }
+    }
+  }
+}
+
+// crend
+SCENARIO("Calling crend iterator on a graph") {
+  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "c", 1);
+    WHEN("crend is called") {
+      auto end = g.crend();
+      end--;
+      THEN("crend-- must equal the last edge in sorted order") {
+        REQUIRE(std::get<0>(*end) == "a");
+        REQUIRE(std::get<1>(*end) == "c");
+        REQUIRE(std::get<2>(*end) == 1);
+      }
+      end--;
+      THEN("end should equal now equal the crbegin") { REQUIRE(end == g.crbegin()); }
+    }
+  }
+}
+
+// rbegin
+SCENARIO("Calling rbegin iterator on a graph") {
+  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "c", 1);
+    WHEN("rbegin is called") {
+      auto start = g.rbegin();
+      THEN("start must equal last edge in sorted order") {
+        REQUIRE(std::get<0>(*start) == "b");
+        REQUIRE(std::get<1>(*start) == "c");
+        REQUIRE(std::get<2>(*start) == 5);
+      }
+      start++;
+      THEN("start++ should equal next edge") {
+        REQUIRE(std::get<0>(*start) == "a");
+        REQUIRE(std::get<1>(*start) == "c");
+        REQUIRE(std::get<2>(*start) == 1);
+      }
+      start++;
+      THEN("start++ should now equal rend") { REQUIRE(start == g.rend()); }
+    }
+  }
+}
+
+// rend
+SCENARIO("Calling rend iterator on a graph") {
+  GIVEN("A graph with default constructor and 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "c", 1);
+    WHEN("rend is called") {
+      auto end = g.rend();
+      end--;
+      THEN("crend-- must equal the last edge in sorted order") {
+        REQUIRE(std::get<0>(*end) == "a");
+        REQUIRE(std::get<1>(*end) == "c");
+        REQUIRE(std::get<2>(*end) == 1);
+      }
+      end--;
+      THEN("end should equal now equal the rbegin") { REQUIRE(end == g.rbegin()); }
+    }
+  }
+}
+
+// ----------------------- Operations ------------------------------
+
+// Copy Assignment
+SCENARIO("Create a Graph by copy assigning another graph") {
+  GIVEN("A graph with 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "c", 1);
+    WHEN("Graph is created using the copy assignment") {
+      gdwg::Graph<std::string, int> newG = g;
+      THEN("The 2 graphs are equal") { REQUIRE(g == newG); }
+    }
+    WHEN("A graph with other nodes and edges is copy assigned the graph") {
+      gdwg::Graph<std::string, int> newG{"a", "z"};
+      newG.InsertEdge("z", "a", 2);
+      newG = g;
+      THEN("It only has the nodes and edges of the graph") { REQUIRE(g == newG); }
+    }
+    WHEN("The graph is copy assigned to itself") {
+      auto& self = g;
+      g = self;
+      THEN("It is unchanged") {
+        REQUIRE(g.GetNodes() == std::vector<std::string>{"a", "b", "c"});
+        REQUIRE(g.GetWeights("b", "c") == std::vector<int>{5});
+      }
+    }
+    WHEN("A node is deleted from a copy") {
+      gdwg::Graph<std::string, int> newG = g;
+      newG.DeleteNode("c");
+      THEN("The copy has its own edges and the original keeps its own") {
+        REQUIRE(newG.cbegin() == newG.cend());
+        REQUIRE(g.GetConnected("a") == std::vector<std::string>{"c"});
+        REQUIRE(g.GetConnected("b") == std::vector<std::string>{"c"});
+      }
+    }
+  }
+}
+
+// Move Assignment
+SCENARIO("Create a Graph by move assigning another graph") {
+  GIVEN("A graph with 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "c", 1);
+    WHEN("Graph is created using the move assignment") {
+      gdwg::Graph<std::string, int> newG = std::move(g);
+      THEN("The new graph has 3 nodes and 2 edges") {
+        REQUIRE(newG.IsNode("a"));
+        REQUIRE(newG.IsNode("b"));
+        REQUIRE(newG.IsNode("c"));
+        REQUIRE(newG.isEdge("b", "c", 5));
+        REQUIRE(newG.isEdge("a", "c", 1));
+      }
+      THEN("The old graph has 0 nodes and 0 edges") {
+        REQUIRE(g.GetNodes().size() == 0);
+        REQUIRE(g.cbegin() == g.cend());
+      }
+    }
+  }
+}
+
+// Memory Resource
+SCENARIO("Create a Graph that allocates from a memory resource") {
+  GIVEN("An arena that cannot fall back to the heap") {
+    std::array<std::byte, 1 << 16> buffer;
+    gdwg::MonotonicArena arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    gdwg::Graph<int, int> g{&arena};
+    WHEN("nodes and edges are added and removed") {
+      for (int i = 0; i < 50; i++)
+        g.InsertNode(i);
+      for (int i = 1; i < 50; i++)
+        g.InsertEdge(i - 1, i, i);
+      g.DeleteNode(25);
+      THEN("every node and edge is allocated from the arena") {
+        REQUIRE(g.GetNodes().size() == 49);
+        REQUIRE(g.GetConnected(0) == std::vector<int>{1});
+        REQUIRE(!g.IsConnected(24, 26));
+      }
+    }
+    WHEN("the graph is move assigned to a graph using a pool") {
+      g.InsertNode(1);
+      g.InsertNode(2);
+      g.InsertEdge(1, 2, 3);
+      gdwg::PoolResource pool;
+      gdwg::Graph<int, int> newG{&pool};
+      newG = std::move(g);
+      THEN("the edges are copied into the pool and the old graph is empty") {
+        REQUIRE(newG.isEdge(1, 2, 3));
+        REQUIRE(g.GetNodes().size() == 0);
+        REQUIRE(g.cbegin() == g.cend());
+      }
+    }
+  }
+}
+
+// ----------------------- Methods ---------------------------------
+
+// DeleteNode
+SCENARIO("Storing a graph of integral nodes densely") {
+  GIVEN("The node and weight types that a graph is stored densely for") {
+    THEN("integral nodes with trivially copyable weights are dense and other graphs are not") {
+      REQUIRE(gdwg::isDense<int, double>::value);
+      REQUIRE(gdwg::isDense<std::uint64_t, float>::value);
+      REQUIRE(!gdwg::isDense<std::string, int>::value);
+      REQUIRE(!gdwg::isDense<int, std::string>::value);
+    }
+  }
+  GIVEN("A dense graph with edges inserted out of order") {
+    gdwg::Graph<int, int> g{1, 2, 3};
+    g.InsertEdge(3, 1, 2);
+    g.InsertEdge(1, 3, 5);
+    g.InsertEdge(1, 2, 4);
+    g.InsertEdge(1, 3, 1);
+    g.InsertEdge(2, 1, 3);
+    WHEN("its neighbours are queried") {
+      THEN("they are in order") {
+        REQUIRE(g.GetConnected(1) == std::vector<int>{2, 3, 3});
+        REQUIRE(g.GetWeights(1, 3) == std::vector<int>{1, 5});
+      }
+    }
+    WHEN("an edge is erased and a node is merged into another") {
+      g.erase(1, 3, 1);
+      g.MergeReplace(3, 2);
+      THEN("every edge moves with its node") {
+        std::vector<std::tuple<int, int, int>> vecTuples{
+            std::make_tuple(1, 2, 4), std::make_tuple(1, 2, 5), std::make_tuple(2, 1, 2),
+            std::make_tuple(2, 1, 3)};
+        REQUIRE(g == gdwg::Graph<int, int>(vecTuples));
+        REQUIRE(g.GetConnected(2) == std::vector<int>{1, 1});
+      }
+    }
+  }
+}
+
+SCENARIO("Deleting a Node from a Graph") {
+  GIVEN("A graph with 4 edges and 4 nodes") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2), std::make_tuple("C", "D", 3),
+        std::make_tuple("D", "A", 4)};
+    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
+    WHEN("Node A is Deleted") {
+      bool result = g.DeleteNode("A");
+      THEN("A is actually deleted") { REQUIRE(result); }
+      THEN("There are only 3 nodes now") { REQUIRE(g.GetNodes().size() == 3); }
+      THEN("A is not a node") { REQUIRE(!g.IsNode("A")); }
+      THEN("There are no edges that start or end in A") {
+        for (auto edge = g.cbegin(); edge != g.cend(); edge++) {
+          REQUIRE(std::get<0>(*edge) != "A");
+          REQUIRE(std::get<1>(*edge) != "A");
+        }
+      }
+    }
+    WHEN("Node E is Deleted") {
+      bool result = g.DeleteNode("E");
+      THEN("E is NOT actually deleted") { REQUIRE(!result); }
+      THEN("There are only 4 nodes still") { REQUIRE(g.GetNodes().size() == 4); }
+    }
+  }
+}
+
+// Replace
+SCENARIO("Replacing a Node in a Graph") {
+  GIVEN("A graph with 4 edges and 4 nodes") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2), std::make_tuple("C", "D", 3),
+        std::make_tuple("D", "A", 4)};
+    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
+    WHEN("Node A is replaced with E") {
+      bool replaced = g.Replace("A", "E");
+      THEN("The node is actually replaced") { REQUIRE(replaced); }
+      THEN("There are only 4 nodes still") { REQUIRE(g.GetNodes().size() == 4); }
+      THEN("A is not a node") { REQUIRE(!g.IsNode("A")); }
+      THEN("There are no edges that start or end in A") {
+        for (auto edge = g.cbegin(); edge != g.cend(); edge++) {
+          REQUIRE(std::get<0>(*edge) != "A");
+          REQUIRE(std::get<1>(*edge) != "A");
+        }
+      }
+      THEN("E is a node") { REQUIRE(g.IsNode("E")); }
+      THEN("There is an edge from E->B(1) and D->E(4)") {
+        REQUIRE(g.isEdge("E", "B", 1));
+        REQUIRE(g.isEdge("D", "E", 4));
+      }
+    }
+    WHEN("Node A is replaced with B") {
+      bool replaced = g.Replace("A", "B");
+      THEN("The node is not actually replaced") { REQUIRE(!replaced); }
+      THEN("There are still 4 nodes") { REQUIRE(g.GetNodes().size() == 4); }
+      THEN("B is a node") { REQUIRE(g.IsNode("B")); }
+      THEN("A is a node") { REQUIRE(g.IsNode("A")); }
+      THEN("There is an edge from A->B(1) and D->A(4)") {
+        REQUIRE(g.isEdge("A", "B", 1));
+        REQUIRE(g.isEdge("D", "A", 4));
+      }
+    }
+    WHEN("Node F is rpelaced with B") {
+      REQUIRE_THROWS_WITH(g.Replace("F", "B"),
+                          "Cannot call Graph::Replace on a node that doesn't exist");
+    }
+  }
+}
+
+// MergeReplace
+SCENARIO("Merge Replacing a Node in a Graph") {
+  GIVEN("A graph with 4 edges and 4 nodes") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2), std::make_tuple("C", "D", 3),
+        std::make_tuple("D", "A", 4)};
+    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
+    WHEN("Node A is replaced with B") {
+      g.MergeReplace("A", "B");
+      THEN("There are only 3 nodes now") { REQUIRE(g.GetNodes().size() == 3); }
+      THEN("A is not a node") { REQUIRE(!g.IsNode("A")); }
+      THEN("There are no edges that start or end in A") {
+        for (auto edge = g.cbegin(); edge != g.cend(); edge++) {
+          REQUIRE(std::get<0>(*edge) != "A");
+          REQUIRE(std::get<1>(*edge) != "A");
+        }
+      }
+      THEN("There is an edge from B->B(1) and D->A(4)") {
+        REQUIRE(g.isEdge("B", "B", 1));
+        REQUIRE(g.isEdge("D", "B", 4));
+      }
+    }
+    WHEN("Node A is replaced with B") {
+      g.MergeReplace("A", "B");
+      THEN("There are only 3 nodes now") { REQUIRE(g.GetNodes().size() == 3); }
+      THEN("A is not a node") { REQUIRE(!g.IsNode("A")); }
+      THEN("There are no edges that start or end in A") {
+        for (auto edge = g.cbegin(); edge != g.cend(); edge++) {
+          REQUIRE(std::get<0>(*edge) != "A");
+          REQUIRE(std::get<1>(*edge) != "A");
+        }
+      }
+      THEN("There is an edge from B->B(1) and D->A(4)") {
+        REQUIRE(g.isEdge("B", "B", 1));
+        REQUIRE(g.isEdge("D", "B", 4));
+      }
+    }
+    WHEN("There is an edge from A->A(1) and A->B(1)") {
+      g.InsertEdge("A", "A", 1);
+      AND_WHEN("Node A is replaced by Node B") {
+        g.MergeReplace("A", "B");
+        THEN("There are only 3 nodes now") { REQUIRE(g.GetNodes().size() == 3); }
+        THEN("A is not a node") { REQUIRE(!g.IsNode("A")); }
+        THEN("There are no edges that start or end in A") {
+          for (auto edge = g.cbegin(); edge != g.cend(); edge++) {
+            REQUIRE(std::get<0>(*edge) != "A");
+            REQUIRE(std::get<1>(*edge) != "A");
+          }
+        }
+        THEN("There is an edge from B->B(1) and D->A(4)") {
+          REQUIRE(g.isEdge("B", "B", 1));
+          REQUIRE(g.isEdge("D", "B", 4));
+        }
+        THEN("There is only one edge from B->B(1) (duplicate not added)") {
+          REQUIRE(g.GetWeights("B", "B").size() == 1);
+        }
+      }
+    }
+    WHEN("Node E is rpelaced with B") {
+      REQUIRE_THROWS_WITH(
+          g.MergeReplace("E", "B"),
+          "Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph");
+    }
+    WHEN("Node B is rpelaced with E") {
+      REQUIRE_THROWS_WITH(
+          g.MergeReplace("B", "E"),
+          "Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph");
+    }
+  }
+}
+
+// Clear
+SCENARIO("Clearing a Graph") {
+  GIVEN("A graph with 4 edges and 4 nodes") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2), std::make_tuple("C", "D", 3),
+        std::make_tuple("D", "A", 4)};
+    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
+    WHEN("The graph is cleared") {
+      g.Clear();
+      THEN("The graph is same as a new graph with no edges and no nodes") {
+        gdwg::Graph<std::string, int> clearG;
+        REQUIRE(g == clearG);
+      }
+
+      THEN("New nodes should be able to be inserted") {
+        g.InsertNode("a");
+        g.InsertNode("b");
+        auto nodes = g.GetNodes();
+        REQUIRE(nodes.size() == 2);
+        REQUIRE(nodes[0] == "a");
+        REQUIRE(nodes[1] == "b");
+      }
+    }
+  }
+}
+
+// IsConnected
+SCENARIO("Checking connectivity of 2 nodes in a Graph") {
+  GIVEN("A graph with 4 edges and 4 nodes") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2), std::make_tuple("C", "D", 3),
+        std::make_tuple("D", "A", 4)};
+    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
+    WHEN("The connectivity from A to B is Tested") {
+      bool connected = g.IsConnected("A", "B");
+      THEN("A and B are connected from A to B") { REQUIRE(connected); }
+    }
+    WHEN("The connectivity from B to A is Tested") {
+      bool connected = g.IsConnected("B", "A");
+      THEN("A and B are not connected from B to A") { REQUIRE(!connected); }
+    }
+    WHEN("The connectivity from E to A is Tested") {
+      REQUIRE_THROWS_WITH(
+          g.IsConnected("E", "A"),
+          "Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
+    }
+    WHEN("The connectivity from A to E is Tested") {
+      REQUIRE_THROWS_WITH(
+          g.IsConnected("A", "E"),
+          "Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
+    }
+  }
+}
+
+// GetConnected
+SCENARIO("Getting nodes connected to a given node") {
+  GIVEN("A graph with 4 edges and 4 nodes, 1 Node from A and 0 nodes from D") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2), std::make_tuple("C", "D", 3),
+        std::make_tuple("B", "A", 4)};
+    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
+    WHEN("The connected nodes of A are received") {
+      auto connectedNodes = g.GetConnected("A");
+      THEN("There is one node in the list and it is B") {
+        REQUIRE(connectedNodes.size() == 1);
+        REQUIRE(connectedNodes[0] == "B");
+      }
+    }
+    WHEN("The connected nodes of D are received") {
+      auto connectedNodes = g.GetConnected("D");
+      THEN("There is no nodes in the list") { REQUIRE(connectedNodes.size() == 0); }
+    }
+    WHEN("The connected nodes of A are received") {
+      REQUIRE_THROWS_WITH(g.GetConnected("E"),
+                          "Cannot call Graph::GetConnected if src doesn't exist in the graph");
+    }
+  }
+}
+
+// GetWeights
+SCENARIO("Getting weights for edges between 2 given nodes") {
+  GIVEN("A graph with 4 edges and 4 nodes") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("A", "B", 1), std::make_tuple("A", "B", -1), std::make_tuple("A", "B", 5),
+        std::make_tuple("A", "B", 4)};
+    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
+    WHEN("The weights of edges from A->B are received") {
+      auto weights = g.GetWeights("A", "B");
+      THEN("There are 4 weights") { REQUIRE(weights.size() == 4); }
+      THEN("The weights are sorted") {
+        auto sortedWeights = weights;
+        std::sort(sortedWeights.begin(), sortedWeights.end());
+        REQUIRE(weights == sortedWeights);
+      }
+    }
+    WHEN("The weights from A to E are received") {
+      REQUIRE_THROWS_WITH(
+          g.GetWeights("A", "E"),
+          "Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
+    }
+    WHEN("The weights from E to A are received") {
+      REQUIRE_THROWS_WITH(
+          g.GetWeights("E", "A"),
+          "Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
+    }
+  }
+}
+
+// Adjacency
+SCENARIO("Neighbour queries stay consistent as the graph is modified") {
+  GIVEN("A graph with a self loop and edges in both directions") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("A", "A", 1), std::make_tuple("A", "B", 2), std::make_tuple("B", "A", 3),
+        std::make_tuple("C", "A", 4)};
+    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
+    WHEN("A is replaced with D") {
+      g.Replace("A", "D");
+      THEN("the self loop and both directions follow the new value") {
+        REQUIRE(g.GetConnected("D") == std::vector<std::string>{"B", "D"});
+        REQUIRE(g.GetConnected("B") == std::vector<std::string>{"D"});
+        REQUIRE(g.GetWeights("D", "D") == std::vector<int>{1});
+        REQUIRE(g.IsConnected("C", "D"));
+      }
+    }
+    WHEN("A is deleted") {
+      g.DeleteNode("A");
+      THEN("no other node keeps an edge to A") {
+        REQUIRE(g.GetConnected("B").empty());
+        REQUIRE(g.GetConnected("C").empty());
+        REQUIRE(g.cbegin() == g.cend());
+      }
+    }
+    WHEN("A is merged into B") {
+      g.MergeReplace("A", "B");
+      THEN("the edges of A move to B and the ones that B already had are merged") {
+        REQUIRE(g.GetNodes() == std::vector<std::string>{"B", "C"});
+        REQUIRE(g.GetWeights("B", "B") == std::vector<int>{1, 2, 3});
+        REQUIRE(g.GetConnected("C") == std::vector<std::string>{"B"});
+        REQUIRE(std::distance(g.cbegin(), g.cend()) == 4);
+      }
+    }
+    WHEN("A is merged into itself") {
+      g.MergeReplace("A", "A");
+      THEN("the graph is unchanged") {
+        REQUIRE(g == gdwg::Graph<std::string, int>(vecTuples.begin(), vecTuples.end()));
+      }
+    }
+  }
+}
+
+// erase
+SCENARIO("Erase an edge from the internal representation") {
+  GIVEN("A graph with 4 edges and 4 nodes") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("A", "B", 1), std::make_tuple("A", "B", -1), std::make_tuple("A", "B", 5),
+        std::make_tuple("A", "B", 4)};
+    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
+    WHEN("The edge A->B(1) is erased") {
+      auto erased = g.erase("A", "B", 1);
+      THEN("A->B(1) actually got deleted") { REQUIRE(erased); }
+      THEN("A->B(1) does not exist anymore") { REQUIRE(!g.isEdge("A", "B", 1)); }
+      THEN("A->B(-1) still exists") { REQUIRE(g.isEdge("A", "B", -1)); }
+      THEN("A->B(5) still exists") { REQUIRE(g.isEdge("A", "B", 5)); }
+      THEN("A->B(4) still exists") { REQUIRE(g.isEdge("A", "B", 4)); }
+    }
+    WHEN("The edge B->B(1) is erased") {
+      auto erased = g.erase("B", "B", 1);
+      THEN("B->B(1) did not delete because it does not exist") { REQUIRE(!erased); }
+    }
+  }
+}
+
+SCENARIO("Applying batches of changes to the graph") {
+  GIVEN("A graph with nodes A, B and C and an edge from A to B") {
+    gdwg::Graph<std::string, int> g{"A", "B", "C"};
+    g.InsertEdge("A", "B", 1);
+    WHEN("a batch of edges is inserted") {
+      std::vector<std::tuple<std::string, std::string, int>> batch{
+          std::make_tuple("C", "A", 2), std::make_tuple("A", "B", 1), std::make_tuple("A", "D", 1),
+          std::make_tuple("A", "C", 3), std::make_tuple("C", "A", 2)};
+      auto results = g.InsertEdges(batch);
+      THEN("each edge has its own result in batch order") {
+        using gdwg::BatchResult;
+        REQUIRE(results == std::vector<BatchResult>{BatchResult::Inserted, BatchResult::Duplicate,
+                                                    BatchResult::MissingNode,
+                                                    BatchResult::Inserted, BatchResult::Duplicate});
+        REQUIRE(g.GetConnected("A") == std::vector<std::string>{"B", "C"});
+        REQUIRE(g.GetWeights("C", "A") == std::vector<int>{2});
+      }
+    }
+    WHEN("a batch of edges is erased") {
+      std::vector<std::tuple<std::string, std::string, int>> batch{
+          std::make_tuple("A", "B", 2), std::make_tuple("A", "B", 1)};
+      auto results = g.EraseEdges(std::move(batch));
+      THEN("only the edge in the graph is erased") {
+        using gdwg::BatchResult;
+        REQUIRE(results == std::vector<BatchResult>{BatchResult::Missing, BatchResult::Erased});
+        REQUIRE(g.cbegin() == g.cend());
+      }
+    }
+    WHEN("a batch of nodes is deleted") {
+      auto results = g.DeleteNodes(std::vector<std::string>{"A", "D"});
+      THEN("the node in the graph is deleted along with its edges") {
+        using gdwg::BatchResult;
+        REQUIRE(results == std::vector<BatchResult>{BatchResult::Deleted, BatchResult::Missing});
+        REQUIRE(g.GetNodes() == std::vector<std::string>{"B", "C"});
+        REQUIRE(g.cbegin() == g.cend());
+      }
+    }
+  }
+}
+
+// Iterator find
+SCENARIO("Finding a particular edge in the graph") {
+  GIVEN("A graph with 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "b", 1);
+    WHEN("find is called") {
+      auto it = g.find("a", "b", 1);
+      THEN("iterator should point to the edge from a to b with weight 1") {
+        REQUIRE(std::get<0>(*it) == "a");
+        REQUIRE(std::get<1>(*it) == "b");
+        REQUIRE(std::get<2>(*it) == 1);
+      }
+    }
+
+    WHEN("find is called for a edge that does not exist") {
+      auto it = g.find("a", "c", 2);
+      THEN("iterator should equal cend") { REQUIRE(it == g.cend()); }
+    }
+  }
+}
+
+// Iterator erase
+SCENARIO("Erasing an edge using an iterator in the graph") {
+  GIVEN("A graph with 3 nodes and 2 edges") {
+    gdwg::Graph<std::string, int> g;
+    g.InsertNode("a");
+    g.InsertNode("b");
+    g.InsertNode("c");
+    g.InsertEdge("b", "c", 5);
+    g.InsertEdge("a", "b", 1);
+    auto it = g.find("a", "b", 1);
+    WHEN("erase is called") {
+      it = g.erase(it);
+      THEN("edge should be erased and iterator should point to next edge") {
+        REQUIRE(g.isEdge("a", "b", 1) == false);
+        REQUIRE(std::get<0>(*it) == "b");
+        REQUIRE(std::get<1>(*it) == "c");
+        REQUIRE(std::get<2>(*it) == 5);
+      }
+    }
+
+    WHEN("erase is called for a edge that does not exist") {
+      auto it = g.find("a", "b", 2);
+      it = g.erase(it);
+      THEN("iterator should equal cend") { REQUIRE(it == g.cend()); }
+    }
+  }
+}
+
+// Freeze
+SCENARIO("Freezing a graph into a compressed snapshot") {
+  GIVEN("A graph with 5 edges and 5 nodes") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("B", "D", 5), std::make_tuple("B", "C", -1), std::make_tuple("C", "D", 4),
+        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 3)};
+    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
+    g.InsertNode("E");
+    WHEN("the graph is frozen") {
+      auto frozen = g.Freeze();
+      THEN("iterating the snapshot gives the same edges in both directions") {
+        std::vector<std::tuple<std::string, std::string, int>> forward{g.cbegin(), g.cend()};
+        std::vector<std::tuple<std::string, std::string, int>> reverse{g.crbegin(), g.crend()};
+        REQUIRE(std::vector<std::tuple<std::string, std::string, int>>(
+                    frozen.cbegin(), frozen.cend()) == forward);
+        REQUIRE(std::vector<std::tuple<std::string, std::string, int>>(
+                    frozen.crbegin(), frozen.crend()) == reverse);
+      }
+      THEN("the snapshot answers the same neighbour queries") {
+        REQUIRE(frozen.GetNodes() == g.GetNodes());
+        REQUIRE(frozen.GetConnected("B") == g.GetConnected("B"));
+        REQUIRE(frozen.GetConnected("E").empty());
+        REQUIRE(frozen.GetWeights("B", "C") == std::vector<int>{-1, 3});
+        REQUIRE(frozen.IsConnected("A", "B"));
+        REQUIRE(!frozen.IsConnected("B", "A"));
+      }
+      THEN("the snapshot does not change with the graph") {
+        g.erase("A", "B", 1);
+        REQUIRE(frozen.IsConnected("A", "B"));
+      }
+      THEN("missing nodes are reported the same way") {
+        REQUIRE_THROWS_WITH(
+            frozen.GetConnected("F"),
+            "Cannot call FrozenGraph::GetConnected if src doesn't exist in the graph");
+        REQUIRE_THROWS_WITH(
+            frozen.GetWeights("A", "F"),
+            "Cannot call FrozenGraph::GetWeights if src or dst node don't exist in the graph");
+      }
+    }
+  }
+}
+
+// Save and Load
+SCENARIO("Breadth first traversal of a snapshot") {
+  GIVEN("A snapshot of a small graph with a cycle and a node that can't be reached") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("a", "b", 1), std::make_tuple("a", "b", 2), std::make_tuple("b", "c", 1),
+        std::make_tuple("c", "a", 1), std::make_tuple("c", "d", 1), std::make_tuple("d", "e", 1)};
+    gdwg::Graph<std::string, int> g{vecTuples};
+    g.InsertNode("f");
+    auto frozen = g.Freeze();
+    WHEN("the hops from a node are found") {
+      THEN("every reachable node has its number of hops") {
+        std::vector<std::pair<std::string, std::size_t>> expected{
+            {"a", 0}, {"b", 1}, {"c", 2}, {"d", 3}, {"e", 4}};
+        REQUIRE(frozen.HopDistances("a") == expected);
+      }
+    }
+    WHEN("the nodes within k hops are found") {
+      THEN("only nodes at most k hops away are returned") {
+        REQUIRE(frozen.KHop("c", 0) == std::vector<std::string>{"c"});
+        REQUIRE(frozen.KHop("c", 2) == std::vector<std::string>{"a", "b", "c", "d", "e"});
+        REQUIRE(frozen.KHop("f", 3) == std::vector<std::string>{"f"});
+      }
+    }
+    WHEN("a traversal starts from a node that is not in the snapshot") {
+      REQUIRE_THROWS_WITH(frozen.KHop("z", 1),
+                          "Cannot call FrozenGraph::KHop if src doesn't exist in the graph");
+    }
+  }
+  GIVEN("A snapshot of a large graph with edges of weight 1") {
+    std::vector<std::tuple<int, int, int>> vecTuples;
+    for (int i = 0; i < 20000; i++) {
+      vecTuples.emplace_back(i, (i * 7 + 1) % 20000, 1);
+      vecTuples.emplace_back(i, (i * 13 + 5) % 20000, 1);
+    }
+    gdwg::Graph<int, int> g{vecTuples};
+    auto frozen = g.Freeze();
+    WHEN("the hops are found on one thread and on several") {
+      auto serial = frozen.HopDistances(0, 1);
+      auto parallel = frozen.HopDistances(0, 4);
+      THEN("both agree with the shortest path distances") {
+        auto distances = g.ShortestPaths(0);
+        REQUIRE(serial.size() == distances.size());
+        REQUIRE(std::equal(serial.begin(), serial.end(), distances.begin(),
+                           [](const auto& hops, const auto& distance) {
+                             return hops.first == distance.first &&
+                                    static_cast<int>(hops.second) == distance.second;
+                           }));
+        REQUIRE(parallel == serial);
+      }
+    }
+  }
+}
+
+SCENARIO("Ranking the nodes of a graph") {
+  GIVEN("A graph where every node has one edge in and one edge out") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("a", "b", 1), std::make_tuple("b", "c", 1), std::make_tuple("c", "a", 1)};
+    gdwg::Graph<std::string, int> g{vecTuples};
+    WHEN("the nodes are ranked") {
+      auto ranks = g.PageRank();
+      THEN("every node has the same rank") {
+        REQUIRE(ranks.size() == 3);
+        for (const auto& [node, rank] : ranks)
+          REQUIRE(rank == Approx(1.0 / 3));
+      }
+    }
+  }
+  GIVEN("A graph where a node splits its edges unevenly and a node has no edges out") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("a", "b", 3), std::make_tuple("a", "c", 1), std::make_tuple("b", "a", 1),
+        std::make_tuple("c", "a", 1), std::make_tuple("c", "d", 1)};
+    gdwg::Graph<std::string, int> g{vecTuples};
+    WHEN("the nodes are ranked with and without weights") {
+      auto ranks = g.PageRank();
+      auto weighted = g.WeightedPageRank();
+      THEN("the ranks add up to 1 and only the weighted ranks favour the heavier edge") {
+        auto total = [](const auto& r) {
+          return r[0].second + r[1].second + r[2].second + r[3].second;
+        };
+        REQUIRE(total(ranks) == Approx(1.0));
+        REQUIRE(total(weighted) == Approx(1.0));
+        REQUIRE(ranks[1].second == Approx(ranks[2].second));
+        REQUIRE(weighted[1].second > weighted[2].second);
+      }
+    }
+  }
+  GIVEN("A snapshot of a graph with weighted edges") {
+    std::vector<std::tuple<int, int, double>> vecTuples{
+        std::make_tuple(0, 1, 2.0), std::make_tuple(0, 2, 0.5), std::make_tuple(2, 0, 4.0)};
+    auto frozen = gdwg::Graph<int, double>(vecTuples).Freeze();
+    WHEN("the adjacency matrix is multiplied by a vector") {
+      auto y = frozen.SpMV(std::vector<double>{1.0, 10.0, 100.0});
+      THEN("each entry is the weighted sum over the node's edges") {
+        REQUIRE(y == std::vector<double>{70.0, 0.0, 4.0});
+      }
+    }
+    WHEN("the vector is the wrong size") {
+      REQUIRE_THROWS_WITH(
+          frozen.SpMV(std::vector<double>{1.0}),
+          "Cannot call FrozenGraph::SpMV with a vector that doesn't have a value per node");
+    }
+  }
+  GIVEN("A snapshot of a large graph") {
+    std::vector<std::tuple<int, int, int>> vecTuples;
+    for (int i = 0; i < 20000; i++) {
+      vecTuples.emplace_back(i, (i * 7 + 1) % 20000, 1 + i % 3);
+      vecTuples.emplace_back(i, (i * 13 + 5) % 20000, 1);
+    }
+    auto frozen = gdwg::Graph<int, int>(vecTuples).Freeze();
+    WHEN("the nodes are ranked on one thread and on several") {
+      auto serial = frozen.WeightedPageRank(0.85, 1e-12, 200, 1);
+      auto parallel = frozen.WeightedPageRank(0.85, 1e-12, 200, 4);
+      THEN("both give the same ranks") {
+        REQUIRE(std::equal(serial.begin(), serial.end(), parallel.begin(), parallel.end(),
+                           [](const auto& a, const auto& b) {
+                             return a.first == b.first && a.second == Approx(b.second);
+                           }));
+      }
+    }
+  }
+}
+
+SCENARIO("Finding the connected components of a graph") {
+  GIVEN("A graph with two cycles joined one way and a separate pair of nodes") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("a", "b", 1), std::make_tuple("b", "c", 1), std::make_tuple("c", "a", 1),
+        std::make_tuple("c", "d", 1), std::make_tuple("d", "e", 1), std::make_tuple("e", "d", 1),
+        std::make_tuple("e", "e", 1), std::make_tuple("g", "f", 1)};
+    gdwg::Graph<std::string, int> g{vecTuples};
+    WHEN("the strongly connected components are found") {
+      THEN("each cycle is a component and every other node is on its own") {
+        std::vector<std::pair<std::string, std::size_t>> expected{
+            {"a", 0}, {"b", 0}, {"c", 0}, {"d", 1}, {"e", 1}, {"f", 2}, {"g", 3}};
+        REQUIRE(g.StronglyConnectedComponents() == expected);
+      }
+    }
+    WHEN("the weakly connected components are found") {
+      THEN("the joined cycles are one component and the pair is another") {
+        std::vector<std::pair<std::string, std::size_t>> expected{
+            {"a", 0}, {"b", 0}, {"c", 0}, {"d", 0}, {"e", 0}, {"f", 1}, {"g", 1}};
+        REQUIRE(g.WeaklyConnectedComponents() == expected);
+      }
+    }
+  }
+  GIVEN("A snapshot of one cycle through a large number of nodes") {
+    std::vector<std::tuple<int, int, int>> vecTuples;
+    for (int i = 0; i < 200000; i++)
+      vecTuples.emplace_back(i, (i + 1) % 200000, 1);
+    auto frozen = gdwg::Graph<int, int>(vecTuples).Freeze();
+    WHEN("the strongly connected components are found") {
+      auto components = frozen.StronglyConnectedComponents();
+      THEN("the depth of the search does not overflow the stack and every node is in one") {
+        REQUIRE(std::all_of(components.begin(), components.end(),
+                            [](const auto& component) { return component.second == 0; }));
+      }
+    }
+  }
+  GIVEN("A snapshot of a large graph with many weakly connected components") {
+    std::vector<std::tuple<int, int, int>> vecTuples;
+    for (int i = 0; i < 40000; i++)
+      vecTuples.emplace_back(i, (i * 7 + 3) % 40000 / 10 * 10 + i % 10, 1);
+    auto frozen = gdwg::Graph<int, int>(vecTuples).Freeze();
+    WHEN("the components are found on one thread and on several") {
+      THEN("both give the same components") {
+        REQUIRE(frozen.WeaklyConnectedComponents(1) == frozen.WeaklyConnectedComponents(4));
+      }
+    }
+  }
+}
+
+SCENARIO("Building a graph from many threads at once") {
+  GIVEN("A builder with several shards") {
+    gdwg::GraphBuilder<int, int> builder{4};
+    WHEN("threads insert overlapping edges and nodes at once") {
+      std::vector<std::thread> producers;
+      for (int t = 0; t < 4; t++) {
+        producers.emplace_back([&builder, t] {
+          for (int i = 0; i < 2000; i++)
+            builder.InsertEdge(i % 500, (i * 3 + t) % 500, i % 7);
+          builder.InsertNode(1000 + t);
+        });
+      }
+      for (auto& producer : producers)
+        producer.join();
+      auto g = builder.Finalize();
+      THEN("the graph is the same as one built from every edge on one thread") {
+        std::vector<std::tuple<int, int, int>> vecTuples;
+        for (int t = 0; t < 4; t++) {
+          for (int i = 0; i < 2000; i++)
+            vecTuples.emplace_back(i % 500, (i * 3 + t) % 500, i % 7);
+        }
+        gdwg::Graph<int, int> expected{vecTuples};
+        for (int t = 0; t < 4; t++)
+          expected.InsertNode(1000 + t);
+        REQUIRE(g == expected);
+      }
+      THEN("the builder is left empty") { REQUIRE(builder.Finalize().GetNodes().empty()); }
+    }
+  }
+}
+
+SCENARIO("Copying a graph that is only cloned when it is changed") {
+  GIVEN("A copy on write graph and a copy of it") {
+    gdwg::CopyOnWriteGraph<std::string, int> original{gdwg::Graph<std::string, int>{"a", "b"}};
+    auto copy = original;
+    WHEN("both are only read") {
+      THEN("they share one graph") {
+        REQUIRE(copy.IsShared());
+        REQUIRE(&*copy == &*original);
+        REQUIRE(copy->GetNodes() == std::vector<std::string>{"a", "b"});
+      }
+    }
+    WHEN("the copy is changed") {
+      copy.Mutable().InsertEdge("a", "b", 1);
+      THEN("the copy gets its own graph and the original is unchanged") {
+        REQUIRE(!copy.IsShared());
+        REQUIRE(copy->IsConnected("a", "b"));
+        REQUIRE(!original->IsConnected("a", "b"));
+      }
+    }
+  }
+}
+
+SCENARIO("Sharing a graph between reader threads and a writer") {
+  GIVEN("A shared graph with one node") {
+    gdwg::SharedGraph<int, int> shared{gdwg::Graph<int, int>{0}};
+    WHEN("a snapshot is taken and then a write is published") {
+      auto before = shared.Snapshot();
+      auto reader = shared.MakeReader();
+      REQUIRE(reader.Get().GetNodes() == std::vector<int>{0});
+      shared.Write([](gdwg::Graph<int, int>& g) { g.InsertNode(1); });
+      THEN("the snapshot is unchanged and readers see the new version") {
+        REQUIRE(shared.Version() == 1);
+        REQUIRE(before->GetNodes() == std::vector<int>{0});
+        REQUIRE(reader.Get().GetNodes() == std::vector<int>{0, 1});
+      }
+    }
+    WHEN("a write throws") {
+      REQUIRE_THROWS(shared.Write([](gdwg::Graph<int, int>& g) { g.InsertEdge(0, 5, 1); }));
+      THEN("nothing is published") { REQUIRE(shared.Version() == 0); }
+    }
+    WHEN("readers run while a writer adds edges two at a time") {
+      std::vector<std::thread> readers;
+      std::vector<int> consistent(4, 1);
+      for (int i = 0; i < 4; i++) {
+        readers.emplace_back([&shared, &consistent, i] {
+          auto reader = shared.MakeReader();
+          while (reader.Get().GetNodes().size() < 50) {
+            const auto& g = reader.Get();
+            auto edges = std::distance(g.cbegin(), g.cend());
+            if (edges % 2 != 0 || static_cast<std::size_t>(edges) != 2 * (g.GetNodes().size() - 1))
+              consistent[i] = 0;
+          }
+        });
+      }
+      for (int node = 1; node < 50; node++) {
+        shared.Write([node](gdwg::Graph<int, int>& g) {
+          g.InsertNode(node);
+          g.InsertEdge(0, node, 1);
+          g.InsertEdge(node, 0, 1);
+        });
+      }
+      for (auto& reader : readers)
+        reader.join();
+      THEN("every version a reader saw had both edges of each write") {
+        REQUIRE(consistent == std::vector<int>(4, 1));
+      }
+    }
+  }
+}
+
+SCENARIO("Saving a graph to a binary file and loading it back") {
+  GIVEN("A graph of trivially copyable nodes and weights") {
+    std::vector<std::tuple<int, int, double>> vecTuples{
+        std::make_tuple(1, 2, 0.5), std::make_tuple(2, 3, 1.5), std::make_tuple(1, 3, 2.5)};
+    gdwg::Graph<int, double> g{vecTuples};
+    g.InsertNode(4);
+    auto path = (std::filesystem::temp_directory_path() / "graph_test_int.gdwg").string();
+    g.Save(path);
+    WHEN("the file is mapped as a snapshot") {
+      auto frozen = gdwg::FrozenGraph<int, double>::Load(path);
+      THEN("the snapshot has the same nodes and edges") {
+        REQUIRE(frozen.GetNodes() == g.GetNodes());
+        REQUIRE(std::equal(frozen.cbegin(), frozen.cend(), g.cbegin(), g.cend()));
+        REQUIRE(frozen.GetWeights(1, 3) == std::vector<double>{2.5});
+      }
+    }
+    WHEN("the file is loaded as a graph") {
+      auto loaded = gdwg::Graph<int, double>::Load(path);
+      THEN("the graph is equal to the one that was saved") { REQUIRE(loaded == g); }
+    }
+  }
+  GIVEN("A graph of string nodes") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("hello", "how", 5), std::make_tuple("how", "you?", 1)};
+    gdwg::Graph<std::string, int> g{vecTuples};
+    auto path = (std::filesystem::temp_directory_path() / "graph_test_string.gdwg").string();
+    g.Save(path);
+    WHEN("the file is loaded as a graph") {
+      auto loaded = gdwg::Graph<std::string, int>::Load(path);
+      THEN("the graph is equal to the one that was saved") { REQUIRE(loaded == g); }
+    }
+    WHEN("the file is loaded with the wrong weight type") {
+      using WrongWeights = gdwg::FrozenGraph<std::string, double>;
+      REQUIRE_THROWS_WITH(WrongWeights::Load(path),
+                          "Cannot call FrozenGraph::Load on a file that was not written by Save");
+    }
+  }
+}
+
+SCENARIO("Finding shortest paths in a graph") {
+  GIVEN("A graph with parallel edges, a cycle and a node that can't be reached") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("a", "b", 4), std::make_tuple("a", "b", 1), std::make_tuple("a", "c", 5),
+        std::make_tuple("b", "c", 2), std::make_tuple("c", "a", 1), std::make_tuple("c", "d", 7),
+        std::make_tuple("b", "d", 9)};
+    gdwg::Graph<std::string, int> g{vecTuples};
+    g.InsertNode("e");
+    WHEN("the distances from a node are found") {
+      auto distances = g.ShortestPaths("a");
+      THEN("every reachable node has its shortest distance, using the least parallel edge") {
+        std::vector<std::pair<std::string, int>> expected{{"a", 0}, {"b", 1}, {"c", 3}, {"d", 10}};
+        REQUIRE(distances == expected);
+      }
+    }
+    WHEN("the shortest path between two nodes is found") {
+      auto path = g.ShortestPath("a", "d");
+      THEN("it has the distance and every node along the path") {
+        REQUIRE(path);
+        REQUIRE(path->first == 10);
+        REQUIRE(path->second == std::vector<std::string>{"a", "b", "d"});
+      }
+    }
+    WHEN("the path from a node to itself is found") {
+      auto path = g.ShortestPath("c", "c");
+      THEN("it is just the node") {
+        REQUIRE(path);
+        REQUIRE(path->first == 0);
+        REQUIRE(path->second == std::vector<std::string>{"c"});
+      }
+    }
+    WHEN("the path to a node that can't be reached is found") {
+      THEN("there is no path") { REQUIRE_FALSE(g.ShortestPath("a", "e")); }
+    }
+    WHEN("a path is found from a node that is not in the graph") {
+      REQUIRE_THROWS_WITH(g.ShortestPaths("z"),
+                          "Cannot call Graph::ShortestPaths if src doesn't exist in the graph");
+      REQUIRE_THROWS_WITH(
+          g.ShortestPath("a", "z"),
+          "Cannot call Graph::ShortestPath if src or dst node don't exist in the graph");
+    }
+    WHEN("a negative edge can be reached") {
+      g.InsertEdge("d", "e", -1);
+      REQUIRE_THROWS_WITH(
+          g.ShortestPaths("a"),
+          "Cannot call Graph::ShortestPath or Graph::ShortestPaths with negative weights");
+    }
+  }
+}
+
+SCENARIO("Streaming a graph in from an edge list") {
+  GIVEN("An edge list with blank lines, tabs, a repeated edge and no final newline") {
+    std::istringstream is{"hello how 5\n\n  how\tyou? 1\r\nhello how 5\nyou? hello 2"};
+    WHEN("it is read as a graph") {
+      auto g = gdwg::Graph<std::string, int>::ReadEdgeList(is);
+      THEN("the graph has every distinct edge of the list") {
+        std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+            std::make_tuple("hello", "how", 5), std::make_tuple("how", "you?", 1),
+            std::make_tuple("you?", "hello", 2)};
+        REQUIRE(g == gdwg::Graph<std::string, int>(vecTuples));
+      }
+    }
+  }
+  GIVEN("A file with an edge list that is bigger than one chunk") {
+    auto path = (std::filesystem::temp_directory_path() / "graph_test_edges.txt").string();
+    std::vector<std::tuple<int, int, double>> vecTuples;
+    {
+      std::ofstream file{path};
+      for (int i = 0; i < 200000; i++) {
+        vecTuples.emplace_back(i % 1000, i / 1000, i * 0.5);
+        file << i % 1000 << ' ' << i / 1000 << ' ' << i * 0.5 << '\n';
+      }
+    }
+    WHEN("it is read from a stream") {
+      std::ifstream file{path};
+      auto g = gdwg::Graph<int, double>::ReadEdgeList(file);
+      THEN("the graph has every edge of the file") {
+        REQUIRE(g == gdwg::Graph<int, double>(vecTuples));
+      }
+    }
+    WHEN("it is read from a file descriptor") {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      auto g = gdwg::Graph<int, double>::ReadEdgeList(fd);
+      ::close(fd);
+      THEN("the graph has every edge of the file") {
+        REQUIRE(g == gdwg::Graph<int, double>(vecTuples));
+      }
+    }
+  }
+  GIVEN("An edge list with a malformed line") {
+    using IntGraph = gdwg::Graph<int, int>;
+    WHEN("a line is missing its weight") {
+      std::istringstream is{"1 2 3\n2 3\n"};
+      REQUIRE_THROWS_WITH(
+          IntGraph::ReadEdgeList(is),
+          "Cannot call Graph::ReadEdgeList on a line that is not \"src dst weight\"");
+    }
+    WHEN("a weight is not a number") {
+      std::istringstream is{"1 2 3\n2 3 x\n"};
+      REQUIRE_THROWS_WITH(IntGraph::ReadEdgeList(is),
+                          "Cannot call Graph::ReadEdgeList on a field that can't be parsed");
+    }
+  }
+}
+
+// Stats
+SCENARIO("Operation counters are collected only when stats are enabled") {
+  GIVEN("A graph with 3 nodes and 3 edges built after the counters are reset") {
+    using IntGraph = gdwg::Graph<int, int>;
+    IntGraph::ResetStats();
+    IntGraph g{1, 2, 3};
+    g.InsertEdge(1, 2, 1);
+    g.InsertEdge(1, 3, 1);
+    g.InsertEdge(2, 3, 1);
+    WHEN("A node with 2 edges is deleted and the edges of another are read") {
+      g.DeleteNode(1);
+      g.GetConnected(2);
+      auto stats = IntGraph::Stats();
+      const auto& deleteNode = stats[gdwg::GraphMethod::DeleteNode];
+#ifdef GDWG_ENABLE_STATS
+      THEN("Every call, the edges it scanned and its latency are counted") {
+        REQUIRE(stats[gdwg::GraphMethod::InsertEdge].calls_ == 3);
+        REQUIRE(deleteNode.calls_ == 1);
+        REQUIRE(deleteNode.edgesScanned_ == 2);
+        REQUIRE(stats[gdwg::GraphMethod::GetConnected].edgesScanned_ == 1);
+        REQUIRE(std::accumulate(deleteNode.latency_.begin(), deleteNode.latency_.end(),
+                                std::uint64_t{0}) == 1);
+      }
+      THEN("Comparisons and allocations are counted") {
+        REQUIRE(stats.nodeComparisons_ > 0);
+        REQUIRE(stats.edgeComparisons_ > 0);
+        REQUIRE(stats.allocations_ > 0);
+        REQUIRE(stats.bytesAllocated_ >= stats.allocations_);
+      }
+#else
+      THEN("Nothing is counted") {
+        REQUIRE(stats[gdwg::GraphMethod::InsertEdge].calls_ == 0);
+        REQUIRE(deleteNode.edgesScanned_ == 0);
+        REQUIRE(stats.nodeComparisons_ == 0);
+        REQUIRE(stats.allocations_ == 0);
+      }
+#endif
+    }
+    WHEN("The counters are reset") {
+      IntGraph::ResetStats();
+      auto stats = IntGraph::Stats();
+      THEN("They are all zero") {
+        REQUIRE(stats[gdwg::GraphMethod::InsertEdge].calls_ == 0);
+        REQUIRE(stats.edgeComparisons_ == 0);
+        REQUIRE(stats.bytesAllocated_ == 0);
+      }
+    }
+  }
+}
+
+// ----------------------- Friends ---------------------------------
+
+// Outstream Operator Overload
+SCENARIO("Print a graph using the output stream") {
+  GIVEN("A graph with 4 edges and 4 nodes") {
+    std::vector<std::tuple<std::string, std::string, int>> vecTuples{
+        std::make_tuple("B", "D", 5), std::make_tuple("B", "C", -1), std::make_tuple("C", "D", 4),
+        std::make_tuple("A", "B", 1)};
+    gdwg::Graph<std::string, int> g{vecTuples.begin(), vecTuples.end()};
+    WHEN("It is printed using the output stream") {
+      std::stringstream v;
+      v << g;
+      THEN("Then it is printed in the following format:\n[node1][1 space](\n[2 "
+           "spaces][node1_connected_node1][1 space][pipe][1 space][weight]\n[2 "
+           "spaces][node1_connected_node2][1 space][pipe][1 space][weight]\n[etc "
+           "etc]\n)\n[node2][1 space](\n[2 spaces][node2_connected_node1][1 space][pipe][1 "
+           "space][weight]\n[2 spaces][node2_connected_node2][1 space][pipe][1 "
+           "space][weight]\n[etc etc]\n)\n[node3][1 space](\n[2 spaces][node3_connected_node1][1 "
+           "space][pipe][1 space][weight]\n[2 spaces][node3_connected_node2][1 space][pipe][1 "
+           "space][weight]\n[etc etc]\n)\n[etc etc]\n"
+           "sorted first by node, then by connected node and then by weight") {
+        REQUIRE(v.str() == "A (\n  B | 1\n)\nB (\n  C | -1\n  D | 5\n)\nC (\n  D | 4\n)\nD (\n)\n");
+      }
+    }
+  }
+  GIVEN("An empty graph is created") {
+    gdwg::Graph<std::string, int> g;
+    WHEN("It is printed using the output stream") {
+      std::stringstream v;
+      v << g;
+      THEN("Then the output is empty") { REQUIRE(v.str() == ""); }
+    }
+  }
+}